@@ -0,0 +1,340 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <cstdint>
+#include "SortCatalog.hpp"
+#include "SortInputs.hpp"
+#include "PerfCounters.hpp"
+#include "SortVerify.hpp"
+
+#define ERROR 1
+#define SUCCESS 0
+
+// Sizes step by 10x, N goes 10, 100, ... up to the maximum
+static const size_t DEFAULT_MIN_SIZE = 10;
+static const size_t DEFAULT_MAX_SIZE = 10000000;
+// Seconds a single sort may be expected to take before it is skipped
+static const double DEFAULT_BUDGET = 2.0;
+// Small sorts are repeated until this much time has been measured
+static const double MIN_MEASURE = 0.05;
+static const size_t MAX_REPS = 10000;
+// Growth in ns/key per 10x more keys beyond which a run is flagged.
+// N log N grows by about 1.3x per decade, N^2 by 10x. Algorithms known
+// to be quadratic are not flagged.
+static const double CLIFF_GROWTH = 5.0;
+// Cliffs are only judged from this size on, smaller timings are noise
+static const size_t CLIFF_MIN_SIZE = 10000;
+
+struct Options {
+    std::vector <const SortAlgorithm *> algorithms;
+    std::vector <SortInput> inputs;
+    size_t minSize;
+    size_t maxSize;
+    double budget;
+    uint64_t seed;
+    bool perf;
+};
+
+/**
+ * What is known about one (algorithm, input) pair from smaller sizes
+ */
+struct History {
+    size_t N;
+    double seconds;
+    double nsPerKey;
+    std::string stopped;
+};
+
+static void Usage(const char * name) {
+    std::cerr << "usage: " << name << " [options]" << std::endl
+              << "  --algorithms A,B,..  default all" << std::endl
+              << "  --inputs X,Y,..      default all, one of:";
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        std::cerr << " " << SortInputName((SortInput) i);
+    }
+    std::cerr << std::endl
+              << "  --min-size N         default " << DEFAULT_MIN_SIZE << std::endl
+              << "  --max-size N         default " << DEFAULT_MAX_SIZE << ", up to 1e9 (needs 16 GB)" << std::endl
+              << "  --budget SECONDS     longest expected single sort, default " << DEFAULT_BUDGET << std::endl
+              << "  --seed S             default 1" << std::endl
+              << "  --perf               add hardware counters per key (cycles, IPC, misses)" << std::endl;
+}
+
+/**
+ * Splits "a,b,c" into its parts
+ * @param list
+ * @return parts
+ */
+static std::vector <std::string> Split(const std::string & list) {
+    std::vector <std::string> parts;
+    std::stringstream ss(list);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+/**
+ * Parses sizes like 1000000 or 1e6
+ * @param text
+ * @return size, 0 when malformed
+ */
+static size_t ParseSize(const std::string & text) {
+    char * end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (*end != '\0' || value < 1) return 0;
+    return (size_t) value;
+}
+
+/**
+ * Fills options from the command line
+ * @param argc
+ * @param argv
+ * @param options
+ * @return false on bad arguments
+ */
+static bool ParseOptions(int argc, char ** argv, Options & options) {
+    options.minSize = DEFAULT_MIN_SIZE;
+    options.maxSize = DEFAULT_MAX_SIZE;
+    options.budget = DEFAULT_BUDGET;
+    options.seed = 1;
+    options.perf = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg == "--perf") {
+            options.perf = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+        if (arg == "--algorithms") {
+            std::vector <std::string> names = Split(value);
+            for (size_t n = 0; n < names.size(); n++) {
+                const SortAlgorithm * algorithm = FindSortAlgorithm(names[n]);
+                if (!algorithm) {
+                    std::cerr << "ERROR: unknown algorithm " << names[n] << std::endl;
+                    return false;
+                }
+                options.algorithms.push_back(algorithm);
+            }
+        } else if (arg == "--inputs") {
+            std::vector <std::string> names = Split(value);
+            for (size_t n = 0; n < names.size(); n++) {
+                SortInput input;
+                if (!ParseSortInput(names[n], input)) {
+                    std::cerr << "ERROR: unknown input " << names[n] << std::endl;
+                    return false;
+                }
+                options.inputs.push_back(input);
+            }
+        } else if (arg == "--min-size") {
+            if (!(options.minSize = ParseSize(value))) return false;
+        } else if (arg == "--max-size") {
+            if (!(options.maxSize = ParseSize(value))) return false;
+        } else if (arg == "--budget") {
+            options.budget = atof(value.c_str());
+            if (options.budget <= 0) return false;
+        } else if (arg == "--seed") {
+            options.seed = strtoull(value.c_str(), nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+
+    if (options.algorithms.empty()) {
+        const std::vector <SortAlgorithm> & all = SortAlgorithms();
+        for (size_t i = 0; i < all.size(); i++) {
+            options.algorithms.push_back(&all[i]);
+        }
+    }
+    if (options.inputs.empty()) {
+        for (int i = 0; i < INPUT_COUNT; i++) {
+            options.inputs.push_back((SortInput) i);
+        }
+    }
+    return options.minSize <= options.maxSize;
+}
+
+/**
+ * Decides from the smaller sizes whether N is worth running. Runs are
+ * extrapolated as N^2 for quadratic algorithms and as N log N otherwise.
+ * Pairs that hit a cliff or failed are not run again, which also keeps
+ * the recursive quick sorts from overflowing the stack on the inputs
+ * that make them quadratic.
+ * @param algorithm
+ * @param history
+ * @param N
+ * @param budget
+ * @return reason to skip, empty to run
+ */
+static std::string SkipReason(const SortAlgorithm & algorithm, const History & history, size_t N,
+        double budget) {
+    if (!history.stopped.empty()) return history.stopped;
+    if (history.N == 0) return "";
+    double growth = (double) N / history.N;
+    double exponent = algorithm.quadratic ? 2.0 : 1.15;
+    double predicted = history.seconds * std::pow(growth, exponent);
+    if (predicted > budget) {
+        std::ostringstream ss;
+        ss << "skipped, expected " << std::setprecision(3) << predicted << " s";
+        return ss.str();
+    }
+    return "";
+}
+
+/**
+ * Times one algorithm on one input pattern. Small inputs are sorted
+ * repeatedly and the best repetition counts. Every repetition gets a
+ * freshly generated input, otherwise the branch predictor learns a
+ * small input by heart and the timings come out far too good.
+ * @param algorithm
+ * @param input
+ * @param N
+ * @param seed
+ * @param counters - hardware counters read around every sort, or nullptr
+ * @param seconds - best time of a single sort
+ * @param sample - counters of the best repetition
+ * @return problem found, empty if the output was a sorted permutation of the input
+ */
+static std::string Measure(const SortAlgorithm & algorithm, SortInput input, size_t N, uint64_t seed,
+        PerfCounters * counters, double & seconds, PerfSample & sample) {
+    std::vector <size_t> work;
+    double total = 0;
+    seconds = 0;
+    for (size_t rep = 0; rep < MAX_REPS && (rep == 0 || total < MIN_MEASURE); rep++) {
+        GenerateSortInput(input, N, seed + rep, work);
+        MultisetHash keys = MultisetHash();
+        if (rep == 0) keys = HashKeys(work.data(), work.size());
+        if (counters) counters->Start();
+        auto startTime = std::chrono::high_resolution_clock::now();
+        try {
+            algorithm.sort(work);
+        } catch (std::string s) {
+            if (counters) counters->Stop();
+            return s;
+        }
+        auto stopTime = std::chrono::high_resolution_clock::now();
+        PerfSample repSample;
+        if (counters) repSample = counters->Stop();
+        double elapsed = std::chrono::duration <double> (stopTime - startTime).count();
+        if (rep == 0) {
+            SortCheck check = VerifySorted(work.data(), work.size());
+            if (!check.sorted) return "WRONG RESULT";
+            if (check.hash != keys) return "WRONG RESULT: keys lost or changed";
+        }
+        total += elapsed;
+        if (rep == 0 || elapsed < seconds) {
+            seconds = elapsed;
+            if (counters) sample = repSample;
+        }
+    }
+    return "";
+}
+
+/**
+ * Benchmarks every algorithm on every input pattern for sizes growing
+ * 10x at a time, reports ns/key and keys/s and flags O(n^2) cliffs
+ * sort_bench [--algorithms ..] [--inputs ..] [--min-size N] [--max-size N] [--budget S] [--seed S]
+ *            [--perf]
+ */
+int main(int argc, char ** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        Usage(argv[0]);
+        return ERROR;
+    }
+    PerfCounters counters;
+    if (options.perf && !counters.Available()) {
+        std::cerr << "WARNING: no hardware counters (perf_event_paranoid, VM without PMU?), reporting n/a"
+                  << std::endl;
+    }
+
+    std::vector <History> history(options.algorithms.size() * options.inputs.size(), History());
+    std::cout << std::left << std::setw(22) << "algorithm" << std::setw(16) << "input"
+              << std::right << std::setw(12) << "N" << std::setw(12) << "ns/key"
+              << std::setw(14) << "keys/s" << "  note" << std::endl;
+
+    for (size_t N = options.minSize; N <= options.maxSize; ) {
+        for (size_t in = 0; in < options.inputs.size(); in++) {
+            for (size_t a = 0; a < options.algorithms.size(); a++) {
+                const SortAlgorithm & algorithm = *options.algorithms[a];
+                History & past = history[in * options.algorithms.size() + a];
+                std::cout << std::left << std::setw(22) << algorithm.name
+                          << std::setw(16) << SortInputName(options.inputs[in])
+                          << std::right << std::setw(12) << N;
+
+                std::string skip = SkipReason(algorithm, past, N, options.budget);
+                if (!skip.empty()) {
+                    std::cout << std::setw(12) << "-" << std::setw(14) << "-" << "  " << skip << std::endl;
+                    continue;
+                }
+
+                double seconds;
+                PerfSample sample;
+                std::string problem = Measure(algorithm, options.inputs[in], N, options.seed,
+                        options.perf ? &counters : nullptr, seconds, sample);
+                if (!problem.empty()) {
+                    past.stopped = problem;
+                    std::cout << std::setw(12) << "-" << std::setw(14) << "-" << "  " << problem << std::endl;
+                    continue;
+                }
+
+                double nsPerKey = seconds * 1e9 / N;
+                std::string note;
+                if (!algorithm.quadratic && N >= CLIFF_MIN_SIZE && past.N == N / 10
+                        && nsPerKey > past.nsPerKey * CLIFF_GROWTH) {
+                    note = "CLIFF: ns/key grows like O(n^2)";
+                    past.stopped = "skipped after O(n^2) cliff";
+                }
+                past.N = N;
+                past.seconds = seconds;
+                past.nsPerKey = nsPerKey;
+
+                std::cout << std::fixed << std::setprecision(2) << std::setw(12) << nsPerKey
+                          << std::scientific << std::setw(14) << N / seconds
+                          << std::defaultfloat << "  " << note;
+                if (options.perf) {
+                    std::cout << (note.empty() ? "" : ", ") << "per key: " << PerfCounters::Describe(sample, 1.0 / N);
+                }
+                std::cout << std::endl;
+            }
+        }
+        if (N > options.maxSize / 10) break;
+        N *= 10;
+    }
+    return SUCCESS;
+}
@@ -25,142 +25,711 @@
  */
 
 #include <iostream>
-#include <time.h>
-#include <stdlib.h>
-#include <cstddef>
-#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
 #include <vector>
 #include <chrono>
-#include <limits.h>
-#include "BubbleSort.hpp"
-#include "SelectionSort.hpp"
-#include "InsertionSort.hpp"
-#include "QuickSort.hpp"
-#include "MergeSort.hpp"
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <memory>
+#include <exception>
 #include "PrintUtil.hpp"
-#include "HeapSort.hpp"
-#include "CountSort.hpp"
+#include "SortCatalog.hpp"
+#include "SortInputs.hpp"
+#include "SortInstrument.hpp"
+#include "PerfCounters.hpp"
+#include "FastReader.hpp"
+#include "MappedSort.hpp"
+#include "SortVerify.hpp"
 
 #define ERROR 1
 #define SUCCESS 0
 
-#define CURRENT_TIME 0
+enum OutputFormat {
+  FORMAT_TABLE,
+  FORMAT_CSV,
+  FORMAT_JSON
+};
 
+struct Options {
+  std::vector <const SortAlgorithm *> algorithms;
+  std::vector <SortInput> inputs;
+  std::vector <size_t> sizes;
+  std::vector <uint64_t> seeds;
+  std::vector <unsigned> threads;
+  size_t warmups;
+  size_t reps;
+  OutputFormat format;
+  bool print;
+  bool counters;
+  bool perf;
+  // keys to sort instead of generated inputs
+  std::string file;
+  bool binary;
+  // binary file sorted in place instead of benchmarking
+  std::string sortFile;
+  size_t keyBits;
+  MappedSortAlgorithm inPlace;
+};
+
+/*
+ * Summary of the per sort times of one configuration, in seconds
+ */
+struct Stats {
+  size_t samples;
+  double min;
+  double median;
+  double p95;
+  double mean;
+  double stddev;
+  // mean per sort, filled with --counters
+  double comparisons;
+  double swaps;
+  double moves;
+  double maxDepth;
+  double auxBytes;
+  // mean per sort, filled with --perf
+  PerfSample perf;
+};
+
+static void Usage(const char * name) {
+  std::cerr << "usage: " << name << " [N] [options]" << std::endl
+            << "  --algorithms A,B,..  default all" << std::endl
+            << "  --inputs X,Y,..      default uniform, one of:";
+  for (int i = 0; i < INPUT_COUNT; i++) {
+    std::cerr << " " << SortInputName((SortInput) i);
+  }
+  std::cerr << std::endl
+            << "  --sizes N,M,..       keys per sort, default 1000" << std::endl
+            << "  --seeds S,T,..       one input series per seed, default 1" << std::endl
+            << "  --threads T,U,..     sorts running at once, default 1" << std::endl
+            << "  --warmups W          untimed runs first, default 1" << std::endl
+            << "  --reps R             timed runs per seed and thread, default 5" << std::endl
+            << "  --format F           table, csv or json, default table" << std::endl
+            << "  --print              print input and output arrays to stderr" << std::endl
+            << "  --counters           report comparisons, swaps, moves, depth and scratch" << std::endl
+            << "                       bytes per sort, needs a MSORT_INSTRUMENT build" << std::endl
+            << "  --perf               report hardware counters per key: cycles, instructions," << std::endl
+            << "                       branch, L1d, LLC and dTLB misses, n/a where unavailable" << std::endl
+            << "  --file PATH          sort the integers in PATH, - for stdin, instead of" << std::endl
+            << "                       generated inputs" << std::endl
+            << "  --binary             --file holds raw little endian 64 bit keys" << std::endl
+            << "  --sort-file PATH     sort a binary key file in place through mmap, with" << std::endl
+            << "                       --algorithms QuickSort (default) or HeapSort" << std::endl
+            << "  --key-bits B         key width of --sort-file, 32 or 64, default 64" << std::endl;
+}
 
 /**
- * Input from command line
- * <sort> <N>
+ * Splits "a,b,c" into its parts
+ * @param list
+ * @return parts
  */
-int main(int argc, char ** argv) {
-  if (argc < 2) {
-    std::cerr << "ERROR: usage "<< argv[0] << " N" << std::endl;
-    return ERROR;
+static std::vector <std::string> Split(const std::string & list) {
+  std::vector <std::string> parts;
+  std::stringstream ss(list);
+  std::string part;
+  while (std::getline(ss, part, ',')) {
+    if (!part.empty()) parts.push_back(part);
   }
+  return parts;
+}
 
-  size_t N = atol(argv[1]);
-  std::vector<size_t> array;
+/**
+ * Parses a non negative integer, 1e6 style included. Parsed as an
+ * integer so 64-bit seeds keep every bit.
+ * @param text
+ * @param value
+ * @return false when malformed, fractional or too big for 64 bits
+ */
+static bool ParseNumber(const std::string & text, uint64_t & value) {
+  size_t e = text.find_first_of("eE");
+  std::string mantissa = text.substr(0, e);
+  if (mantissa.empty() || mantissa.find_first_not_of("0123456789") != std::string::npos) return false;
+  errno = 0;
+  value = strtoull(mantissa.c_str(), nullptr, 10);
+  if (errno == ERANGE) return false;
+  if (e == std::string::npos) return true;
 
-  /* use current time */
-  srand(time(NULL));
+  std::string exponent = text.substr(e + 1);
+  if (exponent.empty() || exponent.size() > 2
+      || exponent.find_first_not_of("0123456789") != std::string::npos) return false;
+  for (int i = atoi(exponent.c_str()); i > 0 && value; i--) {
+    if (value > UINT64_MAX / 10) return false;
+    value *= 10;
+  }
+  return true;
+}
 
-  for (size_t i = 0; i < N; i++) {
-    array.push_back(rand()%100);
+/**
+ * Parses a list of numbers into out
+ * @param text
+ * @param out
+ * @return false when any of them is malformed
+ */
+template <typename T>
+static bool ParseNumbers(const std::string & text, std::vector <T> & out) {
+  std::vector <std::string> parts = Split(text);
+  out.clear();
+  for (size_t i = 0; i < parts.size(); i++) {
+    uint64_t value;
+    if (!ParseNumber(parts[i], value)) return false;
+    out.push_back((T) value);
   }
-  std::vector<size_t> arr_cpy(array);
-#if 1	
-  {
-    PrintArray(array);
-    auto startTime = std::chrono::high_resolution_clock::now();
-    BubbleSort(array);
-    auto stopTime = std::chrono::high_resolution_clock::now();
-    PrintArray(array);
-    std::cout << "BubbleSort - elapsed time : " << PrintTime(startTime, stopTime) <<std::endl; 
+  return !out.empty();
+}
+
+/**
+ * Fills options from the command line
+ * @param argc
+ * @param argv
+ * @param options
+ * @return false on bad arguments
+ */
+static bool ParseOptions(int argc, char ** argv, Options & options) {
+  options.sizes.assign(1, 1000);
+  options.seeds.assign(1, 1);
+  options.threads.assign(1, 1);
+  options.warmups = 1;
+  options.reps = 5;
+  options.format = FORMAT_TABLE;
+  options.print = false;
+  options.counters = false;
+  options.perf = false;
+  options.binary = false;
+  options.keyBits = 64;
+  options.inPlace = MAPPED_QUICK_SORT;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    uint64_t value;
+    if (arg == "--print") {
+      options.print = true;
+      continue;
+    }
+    if (arg == "--counters") {
+      options.counters = true;
+      continue;
+    }
+    if (arg == "--perf") {
+      options.perf = true;
+      continue;
+    }
+    if (arg == "--binary") {
+      options.binary = true;
+      continue;
+    }
+    // a bare number is N, as in the old "sort N"
+    if (arg.compare(0, 2, "--") != 0) {
+      if (!ParseNumber(arg, value)) return false;
+      options.sizes.assign(1, value);
+      continue;
+    }
+    if (i + 1 >= argc) return false;
+    std::string text(argv[++i]);
+    if (arg == "--algorithms") {
+      std::vector <std::string> names = Split(text);
+      for (size_t n = 0; n < names.size(); n++) {
+        const SortAlgorithm * algorithm = FindSortAlgorithm(names[n]);
+        if (!algorithm) {
+          std::cerr << "ERROR: unknown algorithm " << names[n] << std::endl;
+          return false;
+        }
+        options.algorithms.push_back(algorithm);
+      }
+    } else if (arg == "--inputs") {
+      std::vector <std::string> names = Split(text);
+      for (size_t n = 0; n < names.size(); n++) {
+        SortInput input;
+        if (!ParseSortInput(names[n], input)) {
+          std::cerr << "ERROR: unknown input " << names[n] << std::endl;
+          return false;
+        }
+        options.inputs.push_back(input);
+      }
+    } else if (arg == "--file") {
+      options.file = text;
+    } else if (arg == "--sort-file") {
+      options.sortFile = text;
+    } else if (arg == "--key-bits") {
+      if (!ParseNumber(text, value) || (value != 32 && value != 64)) return false;
+      options.keyBits = value;
+    } else if (arg == "--sizes") {
+      if (!ParseNumbers(text, options.sizes)) return false;
+    } else if (arg == "--seeds") {
+      if (!ParseNumbers(text, options.seeds)) return false;
+    } else if (arg == "--threads") {
+      if (!ParseNumbers(text, options.threads)) return false;
+      if (std::count(options.threads.begin(), options.threads.end(), 0u)) return false;
+    } else if (arg == "--warmups") {
+      if (!ParseNumber(text, value)) return false;
+      options.warmups = value;
+    } else if (arg == "--reps") {
+      if (!ParseNumber(text, value) || value == 0) return false;
+      options.reps = value;
+    } else if (arg == "--format") {
+      if (text == "table") options.format = FORMAT_TABLE;
+      else if (text == "csv") options.format = FORMAT_CSV;
+      else if (text == "json") options.format = FORMAT_JSON;
+      else return false;
+    } else {
+      return false;
+    }
   }
 
-  array = arr_cpy;
-  {
-    PrintArray(array);
-    auto startTime = std::chrono::high_resolution_clock::now();
-    SelectionSort(array);
-    auto stopTime = std::chrono::high_resolution_clock::now();
-    PrintArray(array);
-    std::cout << "SelectionSort - elapsed time : " << PrintTime(startTime, stopTime) <<std::endl; 
+  if (!options.sortFile.empty()) {
+    // only the in place sorts work without a second buffer
+    if (options.algorithms.size() > 1) return false;
+    if (!options.algorithms.empty()) {
+      std::string name = options.algorithms[0]->name;
+      if (name == "HeapSort") {
+        options.inPlace = MAPPED_HEAP_SORT;
+      } else if (name != "QuickSort") {
+        std::cerr << "ERROR: --sort-file sorts with QuickSort or HeapSort" << std::endl;
+        return false;
+      }
+    }
   }
+  if (options.algorithms.empty()) {
+    const std::vector <SortAlgorithm> & all = SortAlgorithms();
+    for (size_t i = 0; i < all.size(); i++) {
+      options.algorithms.push_back(&all[i]);
+    }
+  }
+  if (options.inputs.empty()) {
+    options.inputs.push_back(INPUT_UNIFORM);
+  }
+  if (options.counters && !SortInstrumentEnabled()) {
+    std::cerr << "ERROR: --counters needs mSort built with -DMSORT_INSTRUMENT=ON" << std::endl;
+    return false;
+  }
+  return true;
+}
 
-  array = arr_cpy;
-  {
-    PrintArray(array);
-    auto startTime = std::chrono::high_resolution_clock::now();
-    InsertionSort(array);
-    auto stopTime = std::chrono::high_resolution_clock::now();
-    PrintArray(array);
-    std::cout << "InsertionSort - elapsed time : " << PrintTime(startTime, stopTime) <<std::endl; 
+/**
+ * Min, median, 95th percentile, mean and standard deviation, plus the
+ * mean counters per sort
+ * @param samples - reordered
+ * @param counters - one per sample
+ * @param perf - one per sample, an event is valid only if it was in every sample
+ * @return stats
+ */
+static Stats Summarize(std::vector <double> & samples, const std::vector <SortCounters> & counters,
+    const std::vector <PerfSample> & perf) {
+  Stats stats = Stats();
+  for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+    stats.perf.valid[e] = !perf.empty();
+    for (size_t i = 0; i < perf.size(); i++) {
+      stats.perf.value[e] += perf[i].value[e];
+      stats.perf.valid[e] = stats.perf.valid[e] && perf[i].valid[e];
+    }
+    if (!perf.empty()) stats.perf.value[e] /= perf.size();
   }
+  for (size_t i = 0; i < counters.size(); i++) {
+    stats.comparisons += counters[i].comparisons;
+    stats.swaps += counters[i].swaps;
+    stats.moves += counters[i].moves;
+    stats.maxDepth += counters[i].maxDepth;
+    stats.auxBytes += counters[i].auxBytes;
+  }
+  if (!counters.empty()) {
+    stats.comparisons /= counters.size();
+    stats.swaps /= counters.size();
+    stats.moves /= counters.size();
+    stats.maxDepth /= counters.size();
+    stats.auxBytes /= counters.size();
+  }
+  stats.samples = samples.size();
+  if (samples.empty()) return stats;
+  std::sort(samples.begin(), samples.end());
+  size_t N = samples.size();
+  stats.min = samples[0];
+  stats.median = N % 2 ? samples[N / 2] : (samples[N / 2 - 1] + samples[N / 2]) / 2;
+  // nearest rank
+  stats.p95 = samples[(size_t) std::ceil(0.95 * N) - 1];
+  double sum = 0;
+  for (size_t i = 0; i < N; i++) sum += samples[i];
+  stats.mean = sum / N;
+  double squares = 0;
+  for (size_t i = 0; i < N; i++) squares += (samples[i] - stats.mean) * (samples[i] - stats.mean);
+  stats.stddev = N > 1 ? std::sqrt(squares / (N - 1)) : 0;
+  return stats;
+}
 
-#endif    
-  array = arr_cpy;
-  {
-    PrintArray(array);
-    auto startTime = std::chrono::high_resolution_clock::now();
-    QuickSort(array, 0, array.size() - 1);
-    auto stopTime = std::chrono::high_resolution_clock::now();
-    PrintArray(array);
-    std::cout << "QuickSort - elapsed time : " << PrintTime(startTime, stopTime) <<std::endl; 
+/**
+ * Seed of the input for one repetition on one thread, so every sort
+ * sees different keys and the branch predictor cannot learn them
+ * @param seed
+ * @param rep
+ * @param thread
+ * @return seed
+ */
+static uint64_t RunSeed(uint64_t seed, size_t rep, unsigned thread) {
+  return seed ^ ((uint64_t) rep << 24) ^ ((uint64_t) thread << 48);
+}
+
+/**
+ * Runs one round: every thread generates its own input, or copies the
+ * loaded keys, then all of them sort at the same moment
+ * @param algorithm
+ * @param input
+ * @param loaded - keys of --file, null to generate input
+ * @param loadedCount
+ * @param N
+ * @param seed
+ * @param rep
+ * @param threads
+ * @param seconds - one time per thread
+ * @param counters - one per thread
+ * @param perf - one per thread, left empty when measure is false
+ * @param measure - read hardware counters around every sort
+ * @param problem - set when the threads could not start, or a sort threw, left its
+ *     array unsorted or changed its keys
+ * @param skipped - set, and nothing sorted, when the input has keys the algorithm does not take
+ * @param print
+ */
+static void RunRound(const SortAlgorithm & algorithm, SortInput input, const size_t * loaded,
+    size_t loadedCount, size_t N, uint64_t seed, size_t rep, unsigned threads, std::vector <double> & seconds,
+    std::vector <SortCounters> & counters, std::vector <PerfSample> & perf, bool measure, std::string & problem,
+    std::string & skipped, bool print) {
+  std::vector <std::vector <size_t> > arrays(threads);
+  std::vector <MultisetHash> inputs(threads);
+  for (unsigned t = 0; t < threads; t++) {
+    if (loaded == nullptr) {
+      GenerateSortInput(input, N, RunSeed(seed, rep, t), arrays[t]);
+    } else {
+      arrays[t].assign(loaded, loaded + loadedCount);
+    }
+    inputs[t] = HashKeys(arrays[t].data(), arrays[t].size());
+    if (algorithm.maxKey && !arrays[t].empty()
+        && *std::max_element(arrays[t].begin(), arrays[t].end()) > algorithm.maxKey) {
+      std::ostringstream ss;
+      ss << "skipped, keys above " << algorithm.maxKey;
+      skipped = ss.str();
+      return;
+    }
   }
+  // stderr, so csv and json on stdout stay parseable
+  if (print) WriteArray(2, arrays[0], false);
 
-  array = arr_cpy;
-  {
-    PrintArray(array);
-    auto startTime = std::chrono::high_resolution_clock::now();
-    QuickSortIterative(array, 0, array.size() - 1);
-    auto stopTime = std::chrono::high_resolution_clock::now();
-    PrintArray(array);
-    std::cout << "QuickSort Iterative - elapsed time : " << PrintTime(startTime, stopTime) <<std::endl; 
+  seconds.assign(threads, 0);
+  counters.assign(threads, SortCounters());
+  perf.assign(measure ? threads : 0, PerfSample());
+  std::vector <std::string> errors(threads);
+  std::atomic <unsigned> ready(0);
+  std::atomic <bool> cancel(false);
+  std::vector <std::thread> workers;
+  workers.reserve(threads);
+  try {
+    for (unsigned t = 0; t < threads; t++) {
+      workers.emplace_back([&, t]() {
+        // counters only see the thread that opened them
+        std::unique_ptr <PerfCounters> hardware(measure ? new PerfCounters() : nullptr);
+        // start together so the threads really compete
+        ready++;
+        while (ready.load() < threads && !cancel.load()) {
+          std::this_thread::yield();
+        }
+        if (cancel.load()) return;
+        ResetSortCounters();
+        if (hardware) hardware->Start();
+        auto startTime = std::chrono::high_resolution_clock::now();
+        try {
+          algorithm.sort(arrays[t]);
+        } catch (std::string s) {
+          errors[t] = s;
+        } catch (const std::exception & e) {
+          errors[t] = e.what();
+        }
+        auto stopTime = std::chrono::high_resolution_clock::now();
+        if (hardware) perf[t] = hardware->Stop();
+        seconds[t] = std::chrono::duration <double> (stopTime - startTime).count();
+        counters[t] = ThreadSortCounters();
+      });
+    }
+  } catch (const std::exception & e) {
+    // the started threads wait for the rest, let them go without sorting
+    cancel = true;
+    problem = std::string("cannot start threads: ") + e.what();
   }
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+  if (cancel.load()) return;
 
-  array = arr_cpy;
-  {
-    PrintArray(array);
-    auto startTime = std::chrono::high_resolution_clock::now();
-    MergeSort(array, 0, array.size() - 1);
-    auto stopTime = std::chrono::high_resolution_clock::now();
-    PrintArray(array);
-    std::cout << "MergeSort - elapsed time : " << PrintTime(startTime, stopTime) <<std::endl; 
+  if (print) WriteArray(2, arrays[0], false);
+  for (unsigned t = 0; t < threads && problem.empty(); t++) {
+    SortCheck check = VerifySorted(arrays[t].data(), arrays[t].size());
+    if (!errors[t].empty()) {
+      problem = errors[t];
+    } else if (!check.sorted) {
+      problem = "not sorted";
+    } else if (check.hash != inputs[t]) {
+      problem = "keys lost or changed";
+    }
   }
+}
 
-  array = arr_cpy;
-  {
-    PrintArray(array);
-    auto startTime = std::chrono::high_resolution_clock::now();
-    MergeSortIterative(array, 0, array.size() - 1);
-    auto stopTime = std::chrono::high_resolution_clock::now();
-    PrintArray(array);
-    std::cout << "MergeSortIterative - elapsed time : " << PrintTime(startTime, stopTime) <<std::endl; 
+/**
+ * JSON string literal of text
+ * @param text
+ * @return quoted text
+ */
+static std::string Quote(const std::string & text) {
+  std::string quoted("\"");
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] == '"' || text[i] == '\\') quoted += '\\';
+    quoted += text[i];
+  }
+  return quoted + "\"";
+}
+
+/**
+ * Duration in the largest unit it has more than 1000 of (60 for minutes
+ * and hours), truncated, the way PrintTime writes it
+ * @param seconds
+ * @return e.g. "9 ms"
+ */
+static std::string FormatSeconds(double seconds) {
+  static const struct { const char * name; double scale; double next; } units[] = {
+    { "ns", 1e9, 1000 }, { "us", 1e6, 1000 }, { "ms", 1e3, 1000 }, { "s", 1, 60 }, { "min", 1.0 / 60, 60 },
+  };
+  size_t u = 0;
+  while (u < sizeof(units) / sizeof(units[0]) && (uint64_t) (seconds * units[u].scale) > units[u].next) u++;
+  std::ostringstream ss;
+  if (u == sizeof(units) / sizeof(units[0])) {
+    ss << (uint64_t) (seconds / 3600) << " hrs";
+  } else {
+    ss << (uint64_t) (seconds * units[u].scale) << " " << units[u].name;
+  }
+  return ss.str();
+}
+
+/**
+ * Writes one configuration's result in the chosen format
+ * @param options
+ * @param algorithm
+ * @param input - input pattern or file name
+ * @param N
+ * @param threads
+ * @param stats
+ * @param problem
+ * @param skipped - reason the configuration was not run
+ * @param first - first record, for the JSON separator
+ * @return false when nothing was written
+ */
+static bool Report(const Options & options, const SortAlgorithm & algorithm, const std::string & input, size_t N,
+    unsigned threads, const Stats & stats, const std::string & problem, const std::string & skipped, bool first) {
+  if (!skipped.empty() && options.format != FORMAT_TABLE) {
+    // not a measurement, keep it out of the records
+    std::cerr << algorithm.name << " " << input << " " << N << ": " << skipped << std::endl;
+    return false;
+  }
+  double perKey = N ? 1e9 / N : 0;
+  std::ostringstream ss;
+  if (options.format == FORMAT_TABLE) {
+    ss << std::left << std::setw(22) << algorithm.name << std::setw(16) << input
+       << std::right << std::setw(12) << N << std::setw(4) << threads;
+    if (!skipped.empty()) {
+      ss << "  " << skipped;
+    } else if (!problem.empty()) {
+      ss << "  " << problem;
+    } else {
+      ss << std::fixed << std::setprecision(2)
+         << std::setw(12) << stats.min * perKey << std::setw(12) << stats.median * perKey
+         << std::setw(12) << stats.p95 * perKey << std::setw(12) << stats.stddev * perKey
+         << "   median " << FormatSeconds(stats.median);
+      if (options.counters) {
+        ss << std::setprecision(0) << "   cmp " << stats.comparisons << " swp " << stats.swaps
+           << " mov " << stats.moves << " depth " << stats.maxDepth << " aux " << stats.auxBytes << " B";
+      }
+      if (options.perf) {
+        ss << "   per key: " << PerfCounters::Describe(stats.perf, N ? 1.0 / N : 0);
+      }
+    }
+  } else if (options.format == FORMAT_CSV) {
+    ss << algorithm.name << "," << input << "," << N << "," << threads << ","
+       << stats.samples << "," << std::setprecision(9) << stats.min << "," << stats.median << ","
+       << stats.p95 << "," << stats.mean << "," << stats.stddev << ",";
+    if (options.counters) {
+      ss << stats.comparisons << "," << stats.swaps << "," << stats.moves << ","
+         << stats.maxDepth << "," << stats.auxBytes << ",";
+    }
+    if (options.perf) {
+      // per key, empty where the event is unavailable
+      for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        if (stats.perf.valid[e] && N) ss << (double) stats.perf.value[e] / N;
+        ss << ",";
+      }
+    }
+    ss << problem;
+  } else {
+    ss << (first ? "  {" : ",\n  {")
+       << "\"algorithm\": " << Quote(algorithm.name)
+       << ", \"input\": " << Quote(input)
+       << ", \"n\": " << N << ", \"threads\": " << threads
+       << ", \"samples\": " << stats.samples << std::setprecision(9)
+       << ", \"min_s\": " << stats.min << ", \"median_s\": " << stats.median
+       << ", \"p95_s\": " << stats.p95 << ", \"mean_s\": " << stats.mean
+       << ", \"stddev_s\": " << stats.stddev;
+    if (options.counters) {
+      ss << ", \"comparisons\": " << stats.comparisons << ", \"swaps\": " << stats.swaps
+         << ", \"moves\": " << stats.moves << ", \"max_depth\": " << stats.maxDepth
+         << ", \"aux_bytes\": " << stats.auxBytes;
+    }
+    if (options.perf) {
+      ss << ", \"perf_per_key\": {";
+      for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        ss << (e ? ", " : "") << Quote(PerfCounters::Name((PerfEvent) e)) << ": ";
+        if (stats.perf.valid[e] && N) {
+          ss << (double) stats.perf.value[e] / N;
+        } else {
+          ss << "null";
+        }
+      }
+      ss << "}";
+    }
+    ss << ", \"error\": " << (problem.empty() ? "null" : Quote(problem)) << "}";
+    std::cout << ss.str();
+    return true;
   }
+  std::cout << ss.str() << std::endl;
+  return true;
+}
 
-  array = arr_cpy;
-  {
-    PrintArray(array);
+/**
+ * Sort benchmarking CLI
+ * <sort> [N] [--algorithms ..] [--inputs ..] [--sizes ..] [--seeds ..]
+ *        [--threads ..] [--warmups W] [--reps R] [--format table|csv|json] [--print] [--counters]
+ *        [--perf] [--file PATH [--binary]]
+ * <sort> --sort-file PATH [--key-bits 32|64] [--algorithms QuickSort|HeapSort]
+ * Every configuration is run warmups times untimed and then reps times
+ * per seed, on each thread. Outputs are checked, not printed, unless
+ * --print is given, which writes them to stderr. --sort-file sorts a file in place and exits.
+ */
+int main(int argc, char ** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    Usage(argv[0]);
+    return ERROR;
+  }
+  if (!options.sortFile.empty()) {
     auto startTime = std::chrono::high_resolution_clock::now();
-    HeapSort(array);
+    size_t count;
+    try {
+      count = SortMappedFile(options.sortFile, options.keyBits / 8, options.inPlace);
+    } catch (std::string s) {
+      std::cerr << "ERROR: " << s << std::endl;
+      return ERROR;
+    }
     auto stopTime = std::chrono::high_resolution_clock::now();
-    PrintArray(array);
-    std::cout << "HeapSort - elapsed time : " << PrintTime(startTime, stopTime) <<std::endl; 
+    std::cout << "sorted " << count << " keys of " << options.sortFile << " in "
+              << PrintTime(startTime, stopTime) << std::endl;
+    return SUCCESS;
   }
 
-  array = arr_cpy;
-  {
-    PrintArray(array);
+  // a binary regular file is used straight from the page cache,
+  // everything else is read into loadedKeys
+  std::unique_ptr <MappedFile> mapped;
+  std::vector <size_t> loadedKeys;
+  const size_t * loaded = nullptr;
+  size_t loadedCount = 0;
+  if (!options.file.empty()) {
     auto startTime = std::chrono::high_resolution_clock::now();
     try {
-      CountSort(array);
+      if (options.binary && IsRegularFile(options.file)) {
+        mapped.reset(new MappedFile(options.file));
+        loaded = mapped->Keys();
+        loadedCount = mapped->KeyCount();
+      } else {
+        if (options.binary) {
+          ReadBinaryKeys(options.file, loadedKeys);
+        } else {
+          ReadTextKeys(options.file, loadedKeys);
+        }
+        loaded = loadedKeys.data();
+        loadedCount = loadedKeys.size();
+      }
     } catch (std::string s) {
-      std::cerr << s << std::endl;
+      std::cerr << "ERROR: " << s << std::endl;
+      return ERROR;
     }
     auto stopTime = std::chrono::high_resolution_clock::now();
-    PrintArray(array);
-    std::cout << "CountSort - elapsed time : " << PrintTime(startTime, stopTime) <<std::endl; 
+    if (loadedCount == 0) {
+      std::cerr << "ERROR: no keys in " << options.file << std::endl;
+      return ERROR;
+    }
+    std::cerr << (mapped ? "mapped " : "read ") << loadedCount << " keys in "
+              << PrintTime(startTime, stopTime) << std::endl;
+    // the file is the one input, sorted reps times
+    options.inputs.resize(1);
+    options.sizes.assign(1, loadedCount);
+    options.seeds.resize(1);
+  }
+  if (options.perf && !PerfCounters().Available()) {
+    std::cerr << "WARNING: no hardware counters (perf_event_paranoid, VM without PMU?), reporting n/a"
+              << std::endl;
+  }
+
+  if (options.format == FORMAT_TABLE) {
+    std::cout << std::left << std::setw(22) << "algorithm" << std::setw(16) << "input"
+              << std::right << std::setw(12) << "N" << std::setw(4) << "T"
+              << std::setw(12) << "min ns/key" << std::setw(12) << "median"
+              << std::setw(12) << "p95" << std::setw(12) << "stddev" << std::endl;
+  } else if (options.format == FORMAT_CSV) {
+    std::cout << "algorithm,input,n,threads,samples,min_s,median_s,p95_s,mean_s,stddev_s,"
+              << (options.counters ? "comparisons,swaps,moves,max_depth,aux_bytes," : "");
+    for (int e = 0; options.perf && e < PERF_EVENT_COUNT; e++) {
+      std::cout << PerfCounters::Name((PerfEvent) e) << "_per_key,";
+    }
+    std::cout << "error" << std::endl;
+  } else {
+    std::cout << "[" << std::endl;
+  }
+
+  bool first = true;
+  for (size_t a = 0; a < options.algorithms.size(); a++) {
+    const SortAlgorithm & algorithm = *options.algorithms[a];
+    for (size_t in = 0; in < options.inputs.size(); in++) {
+      for (size_t s = 0; s < options.sizes.size(); s++) {
+        for (size_t t = 0; t < options.threads.size(); t++) {
+          std::vector <double> samples, seconds;
+          std::vector <SortCounters> counters, perSort;
+          std::vector <PerfSample> perf, perfPerSort;
+          std::string problem, skipped;
+          for (size_t w = 0; w < options.warmups && problem.empty() && skipped.empty(); w++) {
+            RunRound(algorithm, options.inputs[in], loaded, loadedCount, options.sizes[s], options.seeds[0],
+                options.reps + w,
+                options.threads[t], seconds, perSort, perfPerSort, false, problem, skipped, false);
+          }
+          for (size_t seed = 0; seed < options.seeds.size() && problem.empty() && skipped.empty(); seed++) {
+            for (size_t rep = 0; rep < options.reps && problem.empty() && skipped.empty(); rep++) {
+              RunRound(algorithm, options.inputs[in], loaded, loadedCount, options.sizes[s], options.seeds[seed], rep,
+                  options.threads[t], seconds, perSort, perfPerSort, options.perf, problem, skipped, options.print);
+              if (!skipped.empty()) break;
+              samples.insert(samples.end(), seconds.begin(), seconds.end());
+              counters.insert(counters.end(), perSort.begin(), perSort.end());
+              perf.insert(perf.end(), perfPerSort.begin(), perfPerSort.end());
+            }
+          }
+          Stats stats = Summarize(samples, counters, perf);
+          std::string input = options.file.empty() ? SortInputName(options.inputs[in]) : options.file;
+          if (Report(options, algorithm, input, options.sizes[s], options.threads[t], stats, problem, skipped,
+              first)) {
+            first = false;
+          }
+        }
+      }
+    }
   }
 
+  if (options.format == FORMAT_JSON) {
+    std::cout << "\n]" << std::endl;
+  }
   return SUCCESS;
 }
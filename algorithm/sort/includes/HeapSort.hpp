@@ -27,10 +27,21 @@
 #ifndef HEAPSORT_HPP
 #define HEAPSORT_HPP
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <Common.hpp>
 
 EXPORT_API void HeapSort(std::vector<size_t> & arr);
 
+/**
+ * In place heap sort of [first, last) for raw key arrays such as a
+ * memory mapped file. Builds the heap once and sifts down, so it is
+ * O(n log n) with no extra memory.
+ * @param first
+ * @param last
+ */
+EXPORT_API void HeapSort(uint32_t * first, uint32_t * last);
+EXPORT_API void HeapSort(uint64_t * first, uint64_t * last);
+
 #endif /* HEAPSORT_HPP */
 
@@ -0,0 +1,38 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef INCREMENTALSORT_HPP
+#define INCREMENTALSORT_HPP
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <Common.hpp>
+
+EXPORT_API void MergeInsertBatch(std::vector <size_t> & sorted, std::vector <size_t> & batch);
+EXPORT_API void RepairSorted(std::vector <size_t> & arr, std::vector <size_t> dirty);
+
+#endif /* INCREMENTALSORT_HPP */
+
@@ -27,10 +27,73 @@
 #ifndef INSERTIONSORT_HPP
 #define INSERTIONSORT_HPP
 #include <cstddef>
+#include <cstring>
 #include <vector>
+#include <algorithm>
+#include <type_traits>
 #include <Common.hpp>
+#include "SortInstrument.hpp"
 
 EXPORT_API void InsertionSort(std::vector <size_t > & arr);
 
+/**
+ * Index of the first element in base[0, N) bigger than key.
+ * The loop halves the range a fixed number of times and picks the half
+ * with a conditional move, so it does not depend on the branch predictor.
+ * @param base
+ * @param N
+ * @param key
+ * @return
+ */
+template <typename T>
+inline size_t BranchlessUpperBound(const T * base, size_t N, const T & key) {
+    if (N == 0) return 0;
+    const T * first = base;
+    while (N > 1) {
+        MSORT_COMPARE(1);
+        size_t half = N / 2;
+        base = (key < base[half]) ? base : base + half;
+        N -= half;
+    }
+    MSORT_COMPARE(1);
+    return (base - first) + !(key < *base);
+}
+
+/**
+ * Binary insertion sort on [first, last). Each element finds its slot
+ * with BranchlessUpperBound and the elements in between are shifted as
+ * one block (memmove for trivially copyable types). Stable.
+ * TC - O(n log n) compares, O(n^2) moves done as block copies
+ * @param first
+ * @param last
+ */
+template <typename T>
+void BinaryInsertionSort(T * first, T * last) {
+    size_t N = last - first;
+    for (size_t i = 1; i < N; i++) {
+        // already in place, common for nearly sorted input
+        MSORT_COMPARE(1);
+        if (!(first[i] < first[i - 1])) continue;
+        size_t pos = BranchlessUpperBound(first, i, first[i]);
+        T temp = std::move(first[i]);
+        if (std::is_trivially_copyable<T>::value) {
+            std::memmove((void *) (first + pos + 1), (const void *) (first + pos), (i - pos) * sizeof(T));
+        } else {
+            std::move_backward(first + pos, first + i, first + i + 1);
+        }
+        first[pos] = std::move(temp);
+        MSORT_MOVE(i - pos + 1);
+    }
+}
+
+/**
+ * Binary insertion sort for any element type with operator <
+ * @param arr
+ */
+template <typename T>
+void BinaryInsertionSort(std::vector <T> & arr) {
+    BinaryInsertionSort(arr.data(), arr.data() + arr.size());
+}
+
 #endif /* INSERTIONSORT_HPP */
 
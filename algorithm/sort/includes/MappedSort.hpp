@@ -0,0 +1,52 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef MAPPEDSORT_HPP
+#define MAPPEDSORT_HPP
+#include <cstddef>
+#include <string>
+#include <Common.hpp>
+
+// In place sorts SortMappedFile can use, neither needs a second buffer
+enum MappedSortAlgorithm {
+    MAPPED_QUICK_SORT,
+    MAPPED_HEAP_SORT
+};
+
+/**
+ * Sorts a binary file of unsigned keys in place. The file is mapped
+ * MAP_SHARED and sorted right in the page cache, then msync'd, so a
+ * file that fits in memory costs no read or write copies and no second
+ * buffer. Keys are in host byte order (little endian on x86).
+ * Errors are thrown as std::string.
+ * @param path
+ * @param keyBytes - 4 for uint32 keys, 8 for uint64 keys
+ * @param algorithm
+ * @return number of keys sorted
+ */
+EXPORT_API size_t SortMappedFile(const std::string & path, size_t keyBytes, MappedSortAlgorithm algorithm);
+
+#endif /* MAPPEDSORT_HPP */
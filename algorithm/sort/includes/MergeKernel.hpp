@@ -0,0 +1,48 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef MERGEKERNEL_HPP
+#define MERGEKERNEL_HPP
+#include <cstddef>
+#include <cstdint>
+#include <Common.hpp>
+
+// Instruction sets MergeBitonic can run on. A request for an ISA the CPU
+// lacks falls back to the best one it has below that.
+enum MergeIsa {
+    MERGE_ISA_AUTO,
+    MERGE_ISA_SCALAR,
+    MERGE_ISA_AVX2,
+    MERGE_ISA_AVX512
+};
+
+EXPORT_API size_t * MergeBranchless(const size_t * left, size_t N1, const size_t * right, size_t N2, size_t * out);
+EXPORT_API size_t * MergeBitonic(const size_t * left, size_t N1, const size_t * right, size_t N2, size_t * out,
+        MergeIsa isa = MERGE_ISA_AUTO);
+EXPORT_API MergeIsa MergeIsaSupported();
+
+#endif /* MERGEKERNEL_HPP */
+
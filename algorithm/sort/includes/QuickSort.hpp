@@ -28,11 +28,23 @@
 #define QUICKSORT_HPP
 #include <cstdint>
 #include <vector>
-#include <cstdint>
+#include <cstddef>
 #include <Common.hpp>
 
 EXPORT_API void QuickSort(std::vector <size_t> & arr, const int64_t & low, const int64_t & high);
 EXPORT_API void QuickSortIterative(std::vector <size_t> & arr, const int64_t & low, const int64_t & high);
+EXPORT_API void DualPivotQuickSort(std::vector <size_t> & arr, const int64_t & low, const int64_t & high);
+
+/**
+ * In place quick sort of [first, last) for raw key arrays such as a
+ * memory mapped file. Median of three pivots and Hoare partitioning,
+ * falling back to heap sort when the pivots keep going bad, so it is
+ * O(n log n) in the worst case with O(log n) stack and no extra memory.
+ * @param first
+ * @param last
+ */
+EXPORT_API void QuickSort(uint32_t * first, uint32_t * last);
+EXPORT_API void QuickSort(uint64_t * first, uint64_t * last);
 
 #endif /* QUICKSORT_HPP */
 
@@ -0,0 +1,81 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef RADIXSORT_HPP
+#define RADIXSORT_HPP
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <Common.hpp>
+
+/*
+ * One key field inside a record. Fields are listed most significant
+ * first. By default a field is an unsigned little endian integer of
+ * 1 to 8 bytes. A bytewise field of any width compares its bytes
+ * lexicographically, the way a UUID or a big endian number orders.
+ */
+struct RadixKeyField {
+    size_t offset;
+    size_t width;
+    bool bytewise;
+    RadixKeyField(size_t offset, size_t width, bool bytewise = false) :
+        offset(offset), width(width), bytewise(bytewise) {
+    }
+};
+
+/*
+ * 128 bit key, ordered by hi then lo. Fits (hash, timestamp) pairs and
+ * UUIDs loaded as two big endian halves.
+ */
+struct Key128 {
+    uint64_t hi;
+    uint64_t lo;
+    bool operator<(const Key128 & other) const {
+        return hi < other.hi || (hi == other.hi && lo < other.lo);
+    }
+    bool operator==(const Key128 & other) const {
+        return hi == other.hi && lo == other.lo;
+    }
+};
+
+EXPORT_API void RadixSortRecords(void * base, size_t count, size_t recordSize,
+        const std::vector <RadixKeyField> & fields);
+EXPORT_API void RadixSort128(std::vector <Key128> & arr);
+
+/**
+ * Radix sorts an array of trivially copyable structs by the given fields
+ * @param arr
+ * @param fields
+ */
+template <typename T>
+void RadixSortRecords(std::vector <T> & arr, const std::vector <RadixKeyField> & fields) {
+    static_assert(std::is_trivially_copyable<T>::value, "records are moved with memcpy");
+    RadixSortRecords(arr.data(), arr.size(), sizeof(T), fields);
+}
+
+#endif /* RADIXSORT_HPP */
+
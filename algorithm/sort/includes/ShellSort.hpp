@@ -0,0 +1,102 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SHELLSORT_HPP
+#define SHELLSORT_HPP
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <Common.hpp>
+#include "SortInstrument.hpp"
+
+// Gap sequences ShellSort can use
+enum ShellGaps {
+    // 1, 4, 10, 23, 57, 132, 301, 701, 1750, then * 2.25
+    SHELL_GAPS_CIURA,
+    // ceil((9 * (9/4)^k - 4) / 5): 1, 4, 9, 20, 46, 103, 233, ...
+    SHELL_GAPS_TOKUDA
+};
+
+/**
+ * Gaps below N for the given sequence, smallest first
+ * @param N
+ * @param gaps
+ * @return
+ */
+inline std::vector <size_t> ShellGapSequence(size_t N, ShellGaps gaps) {
+    std::vector <size_t> seq;
+    if (gaps == SHELL_GAPS_CIURA) {
+        static const size_t ciura[] = { 1, 4, 10, 23, 57, 132, 301, 701, 1750 };
+        for (size_t i = 0; ; i++) {
+            size_t gap = (i < 9) ? ciura[i] : (size_t) (seq.back() * 2.25);
+            if (gap >= N && !seq.empty()) break;
+            seq.push_back(gap);
+        }
+    } else {
+        // h is (9/4)^k
+        for (double h = 1; ; h *= 2.25) {
+            size_t gap = (size_t) std::ceil((9 * h - 4) / 5);
+            if (gap >= N && !seq.empty()) break;
+            seq.push_back(gap);
+        }
+    }
+    return seq;
+}
+
+/**
+ * Shell sort, an insertion sort over elements gap apart with a shrinking
+ * gap. Far out of place elements move a long way in few steps, which
+ * makes it a good fit for mid size and partially sorted inputs where
+ * plain insertion sort is quadratic. Not stable.
+ * TC - about O(n^1.25) on average with either sequence
+ * @param arr
+ * @param gaps
+ */
+template <typename T>
+void ShellSort(std::vector <T> & arr, ShellGaps gaps = SHELL_GAPS_CIURA) {
+    size_t N = arr.size();
+    if (N < 2) return;
+    std::vector <size_t> seq = ShellGapSequence(N, gaps);
+
+    for (size_t g = seq.size(); g-- > 0;) {
+        size_t gap = seq[g];
+        for (size_t i = gap; i < N; i++) {
+            T temp = std::move(arr[i]);
+            size_t j = i;
+            while (j >= gap && (MSORT_COMPARE(1), temp < arr[j - gap])) {
+                MSORT_MOVE(1);
+                arr[j] = std::move(arr[j - gap]);
+                j -= gap;
+            }
+            MSORT_MOVE(j != i);
+            arr[j] = std::move(temp);
+        }
+    }
+}
+
+#endif /* SHELLSORT_HPP */
+
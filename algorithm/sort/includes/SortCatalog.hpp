@@ -0,0 +1,52 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SORTCATALOG_HPP
+#define SORTCATALOG_HPP
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <Common.hpp>
+
+typedef void (* SortFunction)(std::vector <size_t> & arr);
+
+/*
+ * Every whole-array sort in mSort behind one signature, so drivers and
+ * benchmarks can loop over them by name
+ */
+struct SortAlgorithm {
+    const char * name;
+    SortFunction sort;
+    // O(n^2) on every input, not worth running on big arrays
+    bool quadratic;
+    // largest key it accepts, 0 when any key is
+    size_t maxKey;
+};
+
+EXPORT_API const std::vector <SortAlgorithm> & SortAlgorithms();
+EXPORT_API const SortAlgorithm * FindSortAlgorithm(const std::string & name);
+
+#endif /* SORTCATALOG_HPP */
@@ -0,0 +1,58 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SORTINPUTS_HPP
+#define SORTINPUTS_HPP
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <Common.hpp>
+
+/*
+ * Input patterns for benchmarking and stress testing the sorts. Besides
+ * random keys these cover the presorted shapes real data tends to have
+ * and inputs known to push quick sorts into their quadratic case.
+ */
+enum SortInput {
+    INPUT_UNIFORM,          // random 64 bit keys
+    INPUT_SORTED,           // 0, 1, ..., N-1
+    INPUT_REVERSE,          // N-1, ..., 1, 0
+    INPUT_ORGAN_PIPE,       // ascending then descending
+    INPUT_SAWTOOTH,         // 32 ascending runs
+    INPUT_FEW_UNIQUE,       // 16 distinct random keys
+    INPUT_ZIPF,             // Zipf(1) ranks, a few keys dominate
+    INPUT_ALL_EQUAL,        // one key repeated
+    INPUT_MEDIAN3_KILLER,   // Musser's median-of-3 killer permutation
+    INPUT_NORMAL,           // normal around 2^40 with standard deviation N
+    INPUT_COUNT
+};
+
+EXPORT_API const char * SortInputName(SortInput input);
+EXPORT_API bool ParseSortInput(const std::string & name, SortInput & input);
+EXPORT_API void GenerateSortInput(SortInput input, size_t N, uint64_t seed, std::vector <size_t> & out);
+
+#endif /* SORTINPUTS_HPP */
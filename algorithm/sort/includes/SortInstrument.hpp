@@ -0,0 +1,154 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SORTINSTRUMENT_HPP
+#define SORTINSTRUMENT_HPP
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <Common.hpp>
+
+/*
+ * What one sort did, counted per thread. Reset before a call and read
+ * after it to get the numbers for that call.
+ */
+struct SortCounters {
+    uint64_t comparisons;   // key comparisons
+    uint64_t swaps;         // exchanges of two keys
+    uint64_t moves;         // single key writes other than swaps
+    uint64_t depth;         // current recursion depth
+    uint64_t maxDepth;      // deepest recursion seen
+    uint64_t auxBytes;      // scratch memory allocated, in bytes
+};
+
+/**
+ * @return this thread's counters
+ */
+inline SortCounters & ThreadSortCounters() {
+    static thread_local SortCounters counters = SortCounters();
+    return counters;
+}
+
+inline void ResetSortCounters() {
+    ThreadSortCounters() = SortCounters();
+}
+
+/**
+ * @return true when libmSort was built with MSORT_INSTRUMENT and its
+ * sorts update the counters
+ */
+EXPORT_API bool SortInstrumentEnabled();
+
+#ifdef MSORT_INSTRUMENT
+
+/*
+ * Counts one level of recursion for as long as it lives
+ */
+struct SortDepthGuard {
+    SortDepthGuard() {
+        SortCounters & counters = ThreadSortCounters();
+        if (++counters.depth > counters.maxDepth) counters.maxDepth = counters.depth;
+    }
+    ~SortDepthGuard() {
+        ThreadSortCounters().depth--;
+    }
+};
+
+#define MSORT_COMPARE(n) (ThreadSortCounters().comparisons += (n))
+#define MSORT_SWAP(n) (ThreadSortCounters().swaps += (n))
+#define MSORT_MOVE(n) (ThreadSortCounters().moves += (n))
+#define MSORT_AUX(bytes) (ThreadSortCounters().auxBytes += (bytes))
+#define MSORT_DEPTH() SortDepthGuard msortDepthGuard
+#define MSORT_MAX_DEPTH(d) (ThreadSortCounters().maxDepth = \
+        std::max <uint64_t> (ThreadSortCounters().maxDepth, (d)))
+
+#else
+
+#define MSORT_COMPARE(n) ((void) 0)
+#define MSORT_SWAP(n) ((void) 0)
+#define MSORT_MOVE(n) ((void) 0)
+#define MSORT_AUX(bytes) ((void) 0)
+#define MSORT_DEPTH() ((void) 0)
+#define MSORT_MAX_DEPTH(d) ((void) 0)
+
+#endif /* MSORT_INSTRUMENT */
+
+/*
+ * Comparator policy for the std algorithms used inside mSort. Plain
+ * operator< unless built with MSORT_INSTRUMENT, then every call counts.
+ */
+struct CountingLess {
+    template <typename T>
+    bool operator()(const T & a, const T & b) const {
+        MSORT_COMPARE(1);
+        return a < b;
+    }
+};
+
+/*
+ * Key policy for the template sorts. Wrapping the element type in
+ * CountedKey counts its comparisons, copies and swaps whatever the
+ * library was built with, since the caller opted in by using it.
+ */
+template <typename T>
+class CountedKey {
+public:
+    CountedKey() : value() {
+    }
+    CountedKey(const T & value) : value(value) {
+    }
+    CountedKey(const CountedKey & other) : value(other.value) {
+        ThreadSortCounters().moves++;
+    }
+    CountedKey & operator=(const CountedKey & other) {
+        ThreadSortCounters().moves++;
+        value = other.value;
+        return *this;
+    }
+    bool operator<(const CountedKey & other) const {
+        ThreadSortCounters().comparisons++;
+        return value < other.value;
+    }
+    bool operator>(const CountedKey & other) const {
+        return other < *this;
+    }
+    bool operator==(const CountedKey & other) const {
+        ThreadSortCounters().comparisons++;
+        return value == other.value;
+    }
+    friend void swap(CountedKey & a, CountedKey & b) {
+        ThreadSortCounters().swaps++;
+        std::swap(a.value, b.value);
+    }
+    const T & get() const {
+        return value;
+    }
+private:
+    T value;
+};
+
+#endif /* SORTINSTRUMENT_HPP */
@@ -0,0 +1,93 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SORTVERIFY_HPP
+#define SORTVERIFY_HPP
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <Common.hpp>
+
+/*
+ * Order independent 128 bit fingerprint of a multiset of keys: the sums
+ * of two independent 64 bit mixes of every key. Sums commute, so any
+ * permutation of the same keys hashes the same and chunks hashed on
+ * different threads just add up.
+ */
+struct MultisetHash {
+    uint64_t low;
+    uint64_t high;
+    uint64_t count;
+
+    bool operator==(const MultisetHash & other) const {
+        return low == other.low && high == other.high && count == other.count;
+    }
+    bool operator!=(const MultisetHash & other) const {
+        return !(*this == other);
+    }
+};
+
+/*
+ * Outcome of VerifySorted
+ */
+struct SortCheck {
+    bool sorted;
+    // index of the first key smaller than the one before it, N if sorted
+    size_t firstUnsorted;
+    MultisetHash hash;
+};
+
+/**
+ * Fingerprints keys[0, N) in parallel chunks
+ * @param keys
+ * @param N
+ * @param threads - 0 for one per hardware thread
+ * @return hash
+ */
+EXPORT_API MultisetHash HashKeys(const size_t * keys, size_t N, unsigned threads = 0);
+
+/**
+ * Checks keys[0, N) is in ascending order and fingerprints it in the
+ * same pass, on parallel chunks, so a 10^9 key output is checked at
+ * memory bandwidth. Compare hash with HashKeys of the input, taken
+ * before sorting, to know the output is a permutation of it without
+ * keeping a copy.
+ * @param keys
+ * @param N
+ * @param threads - 0 for one per hardware thread
+ * @return check
+ */
+EXPORT_API SortCheck VerifySorted(const size_t * keys, size_t N, unsigned threads = 0);
+
+/**
+ * VerifySorted plus the permutation check against the input's hash
+ * @param output
+ * @param input - HashKeys of the unsorted keys
+ * @return true if output is sorted and holds the same keys as the input
+ */
+EXPORT_API bool VerifySort(const std::vector <size_t> & output, const MultisetHash & input);
+
+#endif /* SORTVERIFY_HPP */
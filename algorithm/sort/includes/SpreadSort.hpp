@@ -0,0 +1,59 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SPREADSORT_HPP
+#define SPREADSORT_HPP
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <Common.hpp>
+
+/**
+ * Distribution sort for integer keys. Keys are spread over about n/4
+ * buckets by linear interpolation between min and max; each bucket is
+ * then finished by insertion sort, by another spreading pass, or by a
+ * comparison sort when the distribution turns out to be skewed.
+ * Expected linear time on near uniform keys, O(n log n) worst case.
+ * @param arr
+ */
+EXPORT_API void SpreadSort(std::vector <size_t> & arr);
+
+/**
+ * SpreadSort on [first, last) for callers that manage their own memory
+ * @param first
+ * @param last
+ * @param scratch - room for last - first keys
+ */
+EXPORT_API void SpreadSort(size_t * first, size_t * last, size_t * scratch);
+
+/**
+ * Same as above for doubles, in the order of operator< with -0.0 placed
+ * before +0.0. NaNs with the sign bit clear go last, the rest first.
+ * @param arr
+ */
+EXPORT_API void SpreadSort(std::vector <double> & arr);
+
+#endif /* SPREADSORT_HPP */
@@ -0,0 +1,498 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "BlockMergeSort.hpp"
+#include "MergeKernel.hpp"
+#include "SortInstrument.hpp"
+#include <algorithm>
+
+// Runs of this size are sorted with insertion sort before merging starts
+static const int64_t BLOCK_SIZE = 16;
+
+/**
+ * Stable insertion sort of the range [low, high)
+ * @param arr
+ * @param low
+ * @param high
+ * @param less
+ */
+template <typename Less>
+static void InsertionSortBlock(size_t * arr, int64_t low, int64_t high, Less less) {
+    for (int64_t i = low + 1; i < high; i++) {
+        size_t temp = arr[i];
+        int64_t j = i;
+        // strict compare keeps equal keys in their original order
+        while (j > low && less(temp, arr[j - 1])) {
+            MSORT_MOVE(1);
+            arr[j] = arr[j - 1];
+            j--;
+        }
+        MSORT_MOVE(j != i);
+        arr[j] = temp;
+    }
+}
+
+/**
+ * Merge [low, mid) and [mid, high) when the left run fits in the buffer.
+ * The output can never overtake the unread part of the right run, so
+ * only the left run has to be copied out.
+ * @param arr
+ * @param low
+ * @param mid
+ * @param high
+ * @param buf
+ */
+static void MergeLeftBuffered(size_t * arr, int64_t low, int64_t mid, int64_t high, size_t * buf) {
+    MSORT_MOVE(2 * (mid - low) + (high - mid));
+    MSORT_COMPARE(high - low - 1);
+    std::copy(arr + low, arr + mid, buf);
+    MergeBranchless(buf, mid - low, arr + mid, high - mid, arr + low);
+}
+
+/**
+ * Mirror image of MergeLeftBuffered, used when only the right run fits
+ * in the buffer. Merges from the back.
+ * @param arr
+ * @param low
+ * @param mid
+ * @param high
+ * @param buf
+ */
+static void MergeRightBuffered(size_t * arr, int64_t low, int64_t mid, int64_t high, size_t * buf) {
+    MSORT_MOVE(high - mid);
+    std::copy(arr + mid, arr + high, buf);
+    int64_t i = mid - 1, j = high - mid - 1, k = high - 1;
+    while (i >= low && j >= 0) {
+        // take from the right on ties to stay stable
+        MSORT_COMPARE(1);
+        MSORT_MOVE(1);
+        if (buf[j] < arr[i]) {
+            arr[k--] = arr[i--];
+        } else {
+            arr[k--] = buf[j--];
+        }
+    }
+    MSORT_MOVE(j + 1);
+    while (j >= 0) {
+        arr[k--] = buf[j--];
+    }
+}
+
+/**
+ * Stable merge of [low, mid) and [mid, high) in O(1) extra space.
+ * The longer run is cut in half, the matching split point of the other
+ * run is found by binary search and the two middle blocks are rotated
+ * into place. Both halves are then merged recursively. As soon as one
+ * side of a sub merge fits into the caller provided buffer we switch to
+ * a linear buffered merge. Only used when the input has too few
+ * distinct keys for an internal buffer.
+ * TC - O(n log n) per merge without a buffer, O(n) with a large enough one
+ * @param arr
+ * @param low
+ * @param mid
+ * @param high
+ * @param buf
+ * @param bufSize
+ */
+static void RotationMerge(size_t * arr, int64_t low, int64_t mid, int64_t high,
+        size_t * buf, int64_t bufSize) {
+    MSORT_DEPTH();
+    while (low < mid && mid < high) {
+        // already in order, nothing to do
+        MSORT_COMPARE(1);
+        if (arr[mid - 1] <= arr[mid]) return;
+
+        int64_t N1 = mid - low;
+        int64_t N2 = high - mid;
+        if (N1 <= bufSize) {
+            MergeLeftBuffered(arr, low, mid, high, buf);
+            return;
+        }
+        if (N2 <= bufSize) {
+            MergeRightBuffered(arr, low, mid, high, buf);
+            return;
+        }
+        if (N1 + N2 == 2) {
+            MSORT_SWAP(1);
+            std::swap(arr[low], arr[mid]);
+            return;
+        }
+
+        int64_t cut1, cut2;
+        if (N1 > N2) {
+            cut1 = low + N1/2;
+            cut2 = std::lower_bound(arr + mid, arr + high, arr[cut1], CountingLess()) - arr;
+        } else {
+            cut2 = mid + N2/2;
+            cut1 = std::upper_bound(arr + low, arr + mid, arr[cut2], CountingLess()) - arr;
+        }
+        MSORT_MOVE(cut2 - cut1);
+        std::rotate(arr + cut1, arr + mid, arr + cut2);
+        int64_t newMid = cut1 + (cut2 - mid);
+
+        // recurse into the smaller half and loop on the bigger one so the
+        // stack stays O(log n) deep
+        if ((newMid - low) < (high - newMid)) {
+            RotationMerge(arr, low, cut1, newMid, buf, bufSize);
+            low = newMid;
+            mid = cut2;
+        } else {
+            RotationMerge(arr, newMid, cut2, high, buf, bufSize);
+            high = newMid;
+            mid = cut1;
+        }
+    }
+}
+
+/**
+ * Bottom up merge sort of [0, N) with rotation merges, for inputs
+ * without enough distinct keys for the internal buffer.
+ * TC - O(n log^2 n), O(n log n) when the buffer holds half the input
+ * @param arr
+ * @param N
+ * @param buf
+ * @param bufSize
+ */
+static void RotationMergeSort(size_t * arr, int64_t N, size_t * buf, int64_t bufSize) {
+    for (int64_t low = 0; low < N; low += BLOCK_SIZE) {
+        InsertionSortBlock(arr, low, std::min(low + BLOCK_SIZE, N), CountingLess());
+    }
+
+    for (int64_t width = BLOCK_SIZE; width < N; width *= 2) {
+        for (int64_t low = 0; low < N - width; low += 2*width) {
+            RotationMerge(arr, low, low + width, std::min(low + 2*width, N), buf, bufSize);
+        }
+    }
+}
+
+/**
+ * Moves the first occurrence of up to wanted distinct keys to the front
+ * of [0, N), sorted, keeping every other element in its order. The keys
+ * found so far travel as one sorted block right behind the scan, each
+ * new key is rotated into it.
+ * TC - O(N + wanted^2)
+ * @param arr
+ * @param N
+ * @param wanted
+ * @param less
+ * @return number of keys found
+ */
+template <typename Less>
+static int64_t CollectKeys(size_t * arr, int64_t N, int64_t wanted, Less less) {
+    int64_t first = 0, found = 1;
+    for (int64_t u = 1; u < N && found < wanted; u++) {
+        int64_t at = std::lower_bound(arr + first, arr + first + found, arr[u], less) - arr;
+        if (at == first + found || less(arr[u], arr[at])) {
+            // new key, drag the block up to it and slot it in
+            MSORT_MOVE(u - first);
+            std::rotate(arr + first, arr + first + found, arr + u);
+            at += u - first - found;
+            first = u - found;
+            MSORT_MOVE(u - at + 1);
+            std::rotate(arr + at, arr + u, arr + u + 1);
+            found++;
+        }
+    }
+    MSORT_MOVE(first + found);
+    std::rotate(arr, arr + first, arr + first + found);
+    return found;
+}
+
+/**
+ * Merges [low, mid) and [mid, high), the left run no longer than the
+ * internal buffer at buf. The left run is swapped into the buffer and
+ * merged back, each output swaps with a buffer element, so the buffer
+ * keeps its (distinct) keys in some order. Stops early once one run is
+ * used up.
+ * @param arr
+ * @param low
+ * @param mid
+ * @param high
+ * @param buf
+ * @param leftFirst - left run wins ties, otherwise the right one does
+ * @param less
+ * @param rest - set to the start of what is left of the run that was
+ *        not used up, those elements sit at the end of [low, high)
+ * @return true when the left run was used up first
+ */
+template <typename Less>
+static bool MergeLeftSwap(size_t * arr, int64_t low, int64_t mid, int64_t high,
+        size_t * buf, bool leftFirst, Less less, int64_t & rest) {
+    int64_t N1 = mid - low;
+    MSORT_SWAP(N1);
+    std::swap_ranges(arr + low, arr + mid, buf);
+    int64_t i = 0, j = mid, out = low;
+    while (i < N1 && j < high) {
+        MSORT_SWAP(1);
+        if (leftFirst ? less(arr[j], buf[i]) : !less(buf[i], arr[j])) {
+            std::swap(arr[out++], arr[j++]);
+        } else {
+            std::swap(arr[out++], buf[i++]);
+        }
+    }
+    if (i == N1) {
+        rest = j;
+        return true;
+    }
+    // the right run ran out, the rest of the left one goes to the end
+    MSORT_SWAP(N1 - i);
+    std::swap_ranges(buf + i, buf + N1, arr + out);
+    rest = out;
+    return false;
+}
+
+/**
+ * Mirror image of MergeLeftSwap for a right run no longer than the
+ * internal buffer, merged from the back. Left wins ties.
+ * @param arr
+ * @param low
+ * @param mid
+ * @param high
+ * @param buf
+ * @param less
+ */
+template <typename Less>
+static void MergeRightSwap(size_t * arr, int64_t low, int64_t mid, int64_t high,
+        size_t * buf, Less less) {
+    int64_t N2 = high - mid;
+    MSORT_SWAP(N2);
+    std::swap_ranges(arr + mid, arr + high, buf);
+    int64_t i = mid - 1, j = N2 - 1, out = high - 1;
+    while (i >= low && j >= 0) {
+        MSORT_SWAP(1);
+        if (less(buf[j], arr[i])) {
+            std::swap(arr[out--], arr[i--]);
+        } else {
+            std::swap(arr[out--], buf[j--]);
+        }
+    }
+    MSORT_SWAP(j + 1);
+    std::swap_ranges(buf, buf + j + 1, arr + low);
+}
+
+/**
+ * Merges [low, mid) and [mid, high) when both are longer than the
+ * internal buffer. Both runs are cut into blocks of blockLen, the left
+ * run is a whole number of them and the right one may end in a shorter
+ * tail. Block i is tagged with tags[i], the full blocks are selection
+ * sorted by first element with the tag breaking ties, so blocks of the
+ * left run stay first. Walking the sorted blocks, each one is merged
+ * with what is left of the last block from the other run, through the
+ * buffer. The tail is merged in at the end and the tags sorted back.
+ * TC - O(high - low + (blocks)^2)
+ * @param arr
+ * @param low
+ * @param mid
+ * @param high
+ * @param buf
+ * @param blockLen
+ * @param tags
+ * @param less
+ */
+template <typename Less>
+static void CombineBlocks(size_t * arr, int64_t low, int64_t mid, int64_t high,
+        size_t * buf, int64_t blockLen, size_t * tags, Less less) {
+    int64_t leftBlocks = (mid - low) / blockLen;
+    int64_t blocks = leftBlocks + (high - mid) / blockLen;
+    int64_t tail = high - low - blocks * blockLen;
+    // tags below this one mark blocks of the left run
+    size_t midTag = tags[leftBlocks];
+
+    for (int64_t i = 0; i < blocks - 1; i++) {
+        int64_t min = i;
+        for (int64_t j = i + 1; j < blocks; j++) {
+            const size_t & head = arr[low + j * blockLen];
+            const size_t & minHead = arr[low + min * blockLen];
+            if (less(head, minHead) || (!less(minHead, head) && less(tags[j], tags[min]))) {
+                min = j;
+            }
+        }
+        if (min != i) {
+            MSORT_SWAP(blockLen + 1);
+            std::swap_ranges(arr + low + i * blockLen, arr + low + (i + 1) * blockLen,
+                    arr + low + min * blockLen);
+            std::swap(tags[i], tags[min]);
+        }
+    }
+
+    // [rest, block) is what is still unmerged of earlier blocks, all of
+    // them from one run
+    int64_t rest = low;
+    bool restLeft = less(tags[0], midTag);
+    for (int64_t k = 1; k < blocks; k++) {
+        int64_t block = low + k * blockLen;
+        bool blockLeft = less(tags[k], midTag);
+        if (blockLeft == restLeft) {
+            // same run, the rest is already in its final place
+            rest = block;
+        } else {
+            if (MergeLeftSwap(arr, rest, block, block + blockLen, buf, restLeft, less, rest)) {
+                restLeft = blockLeft;
+            }
+        }
+    }
+    if (tail > 0) {
+        MergeRightSwap(arr, low, high - tail, high, buf, less);
+    }
+    InsertionSortBlock(tags, 0, blocks, less);
+}
+
+/**
+ * Merge sort of [low, high) which uses [buf, buf + blockLen) as the
+ * internal buffer and tags as block tags, both distinct keys collected
+ * from the input. Runs up to the buffer size are merged through it,
+ * longer ones block by block. An external buffer, when given, takes
+ * over every merge whose shorter run fits in it.
+ * TC - O(n log n)
+ * @param arr
+ * @param low
+ * @param high
+ * @param buf
+ * @param blockLen
+ * @param tags
+ * @param extBuf
+ * @param extSize
+ * @param less
+ */
+template <typename Less>
+static void InternalBufferSort(size_t * arr, int64_t low, int64_t high, size_t * buf, int64_t blockLen,
+        size_t * tags, size_t * extBuf, int64_t extSize, Less less) {
+    for (int64_t start = low; start < high; start += BLOCK_SIZE) {
+        InsertionSortBlock(arr, start, std::min(start + BLOCK_SIZE, high), less);
+    }
+
+    for (int64_t width = BLOCK_SIZE; width < high - low; width *= 2) {
+        for (int64_t start = low; start < high - width; start += 2*width) {
+            int64_t mid = start + width;
+            int64_t end = std::min(start + 2*width, high);
+            // already in order, nothing to do
+            if (!less(arr[mid], arr[mid - 1])) continue;
+            if (width <= extSize) {
+                MergeLeftBuffered(arr, start, mid, end, extBuf);
+            } else if (end - mid <= extSize) {
+                MergeRightBuffered(arr, start, mid, end, extBuf);
+            } else if (width <= blockLen) {
+                int64_t rest;
+                MergeLeftSwap(arr, start, mid, end, buf, true, less, rest);
+            } else if (end - mid <= blockLen) {
+                MergeRightSwap(arr, start, mid, end, buf, less);
+            } else {
+                CombineBlocks(arr, start, mid, end, buf, blockLen, tags, less);
+            }
+        }
+    }
+}
+
+/**
+ * Merges the sorted keys [0, keys) into the sorted run [keys, N). Every
+ * key goes before the elements equal to it, the keys being the first
+ * occurrences. The key block is rotated forward to where its first key
+ * belongs, which then stays behind.
+ * TC - O(N + keys^2)
+ * @param arr
+ * @param keys
+ * @param N
+ * @param less
+ */
+template <typename Less>
+static void MergeKeysBack(size_t * arr, int64_t keys, int64_t N, Less less) {
+    int64_t first = 0, next = keys;
+    while (keys > 0 && next < N) {
+        int64_t at = std::lower_bound(arr + next, arr + N, arr[first], less) - arr;
+        if (at > next) {
+            MSORT_MOVE(at - first);
+            std::rotate(arr + first, arr + next, arr + at);
+            first += at - next;
+            next = at;
+        }
+        first++;
+        keys--;
+    }
+}
+
+/**
+ * Internal buffer block merge sort, in the spirit of GrailSort. The
+ * first occurrences of about 2 sqrt(n) distinct keys are collected at
+ * the front, one part of them serves as the merge buffer and the other
+ * tags the blocks of the long merges. Afterwards the keys are sorted
+ * and merged back. Falls back to rotation merging when the input has
+ * too few distinct keys.
+ * @param arr
+ * @param N
+ * @param extBuf
+ * @param extSize
+ * @param less
+ */
+template <typename Less>
+static void BlockMergeSortImpl(size_t * arr, int64_t N, size_t * extBuf, int64_t extSize, Less less) {
+    if (N <= BLOCK_SIZE) {
+        InsertionSortBlock(arr, 0, N, less);
+        return;
+    }
+    int64_t blockLen = BLOCK_SIZE;
+    while (blockLen * blockLen < N) blockLen *= 2;
+    // an external buffer for half the input makes every merge linear
+    if (2 * extSize >= N) {
+        RotationMergeSort(arr, N, extBuf, extSize);
+        return;
+    }
+    int64_t tagCount = N / blockLen + 1;
+    int64_t wanted = tagCount + blockLen;
+    int64_t found = CollectKeys(arr, N, wanted, less);
+    if (found < wanted) {
+        RotationMergeSort(arr, N, extBuf, extSize);
+        return;
+    }
+    InternalBufferSort(arr, wanted, N, arr + tagCount, blockLen, arr, extBuf, extSize, less);
+    // the buffer keys were shuffled by the merges, they are distinct so
+    // any order of sorting them is fine
+    InsertionSortBlock(arr, 0, wanted, less);
+    MergeKeysBack(arr, wanted, N, less);
+}
+
+/**
+ * Stable in place merge sort. Merges run through an internal buffer of
+ * distinct keys taken from the input, so no O(n) buffer is needed.
+ * TC - O(n log n) with at least about 2 sqrt(n) distinct keys, else
+ * O(n log^2 n) with rotation merges. Extra space O(1), plus an O(log n)
+ * stack in the rotation fallback
+ * @param arr
+ */
+void BlockMergeSort(std::vector <size_t> & arr) {
+    BlockMergeSortImpl(arr.data(), arr.size(), nullptr, 0, CountingLess());
+}
+
+/**
+ * Stable in place merge sort which also uses the given buffer as
+ * scratch space. The buffer may be much smaller than arr, every merge
+ * whose shorter side fits into it is a plain buffered merge. The buffer
+ * contents are clobbered.
+ * @param arr
+ * @param buffer
+ */
+void BlockMergeSort(std::vector <size_t> & arr, std::vector <size_t> & buffer) {
+    BlockMergeSortImpl(arr.data(), arr.size(), buffer.data(), buffer.size(), CountingLess());
+}
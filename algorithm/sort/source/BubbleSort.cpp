@@ -25,6 +25,7 @@
  */
 
 #include "BubbleSort.hpp"
+#include "SortInstrument.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
@@ -39,7 +40,9 @@
 	for (int64_t i = 0; i < N-1; i++ ) {
 		bool swapFlag = false;
 		for (int64_t j = 0; j < N-1-i; j++) {
+			MSORT_COMPARE(1);
 			if (arr[j] > arr[j + 1]) {
+				MSORT_SWAP(1);
 				std::swap(arr[j], arr[j+1]);
 				swapFlag = true;
 			}
@@ -25,6 +25,7 @@
  */
 
 #include "CountSort.hpp"
+#include "SortInstrument.hpp"
 #include <algorithm>
 #include <stdint.h>
 #include <string>
@@ -35,6 +36,7 @@
  * @param arr
  */
 void CountSort(std::vector <size_t> & arr) {
+    if (arr.empty()) return;
     auto min = *std::min_element(arr.begin(), arr.end());
     auto max = *std::max_element(arr.begin(), arr.end());
     // TODO throw here
@@ -45,6 +47,7 @@ void CountSort(std::vector <size_t> & arr) {
      
     auto count_vec_size = max - min + 1;
     std::vector <size_t> count(count_vec_size), out(arr.size());
+    MSORT_AUX((count.size() + out.size()) * sizeof(size_t));
     
     for (size_t i = 0; i < arr.size(); i++) {
         count[arr[i]-min]++;
@@ -58,5 +61,6 @@ void CountSort(std::vector <size_t> & arr) {
         out[count[arr[i] - min] - 1] = arr[i];
         count[arr[i] - min]--;
     }
+    MSORT_MOVE(2 * arr.size());
     arr = out;
 }
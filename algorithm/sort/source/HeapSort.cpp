@@ -25,14 +25,62 @@
  */
 
 #include "HeapSort.hpp"
+#include "SortInstrument.hpp"
 #include <algorithm>
 
 void HeapSort(std::vector<size_t> & arr) {
     int N = arr.size(), i = 0;
     while (i < N) {
-        make_heap(arr.begin(), arr.end() - i);
+        make_heap(arr.begin(), arr.end() - i, CountingLess());
         // swap the biggest with its right position
+        MSORT_SWAP(1);
         std::swap(arr.front(), arr[N - i - 1]);
         i++;
     }
 }
+
+/**
+ * Moves first[root] down the heap of N keys until its children are
+ * not bigger
+ * @param first
+ * @param root
+ * @param N
+ */
+template <typename T>
+static void SiftDown(T * first, size_t root, size_t N) {
+    T value = first[root];
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= N) break;
+        if (child + 1 < N && (MSORT_COMPARE(1), first[child] < first[child + 1])) child++;
+        MSORT_COMPARE(1);
+        if (!(value < first[child])) break;
+        MSORT_MOVE(1);
+        first[root] = first[child];
+        root = child;
+    }
+    first[root] = value;
+}
+
+template <typename T>
+static void HeapSortRange(T * first, T * last) {
+    size_t N = last - first;
+    if (N < 2) return;
+    for (size_t i = N / 2; i-- > 0; ) {
+        SiftDown(first, i, N);
+    }
+    for (size_t end = N - 1; end > 0; end--) {
+        // the biggest key goes to the back, the heap shrinks by one
+        MSORT_SWAP(1);
+        std::swap(first[0], first[end]);
+        SiftDown(first, 0, end);
+    }
+}
+
+void HeapSort(uint32_t * first, uint32_t * last) {
+    HeapSortRange(first, last);
+}
+
+void HeapSort(uint64_t * first, uint64_t * last) {
+    HeapSortRange(first, last);
+}
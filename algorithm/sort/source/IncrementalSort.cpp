@@ -0,0 +1,194 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "IncrementalSort.hpp"
+#include "SortInstrument.hpp"
+#include "MergeSort.hpp"
+#include "MergeKernel.hpp"
+#include <algorithm>
+#include <string>
+
+// Galloping pays off once the sorted tail is this many times the batch
+static const size_t GALLOP_RATIO = 16;
+// Up to this many dirty slots are fixed one by one, above it in a batch
+static const size_t REPAIR_ONE_BY_ONE = 64;
+
+/**
+ * Finds the first element in [first, last) bigger than key by probing
+ * first + 1, 2, 4, ... and then binary searching the last gap. Costs
+ * O(log d) where d is the distance to the answer, not the range size.
+ * @param first
+ * @param last
+ * @param key
+ * @return
+ */
+static size_t * GallopUpperBound(size_t * first, size_t * last, const size_t & key) {
+    if (first == last || *first > key) return first;
+    // invariant *lo <= key
+    size_t * lo = first;
+    size_t step = 1;
+    while (step < (size_t) (last - lo) && lo[step] <= key) {
+        lo += step;
+        step *= 2;
+    }
+    size_t * hi = lo + std::min(step, (size_t) (last - lo));
+    return std::upper_bound(lo + 1, hi, key);
+}
+
+/**
+ * Merges the sorted batch with right[0, rightEnd) into out, where out
+ * sits exactly batch size slots in front of right. Every batch key
+ * gallops over the run of right keys that go before it and that run is
+ * moved as one block, so a small batch costs O(k log(n/k)) compares.
+ * @param batch
+ * @param k
+ * @param right
+ * @param rightEnd
+ * @param out
+ */
+static void GallopMerge(const size_t * batch, size_t k, size_t * right, size_t * rightEnd, size_t * out) {
+    for (size_t i = 0; i < k; i++) {
+        // equal keys already in the array stay in front of new ones
+        size_t * run = GallopUpperBound(right, rightEnd, batch[i]);
+        out = std::copy(right, run, out);
+        right = run;
+        *out++ = batch[i];
+    }
+}
+
+/**
+ * Adds a batch of keys to an already sorted array, keeping it sorted.
+ * Only the batch is sorted, the array is extended and the part of it
+ * that is bigger than the smallest new key is merged with the batch
+ * using the batch as the merge buffer.
+ * TC - O(k log k + n), with O(k log(n/k)) compares for small batches
+ * @param sorted - sorted array to insert into
+ * @param batch  - new keys, left sorted on return
+ */
+void MergeInsertBatch(std::vector <size_t> & sorted, std::vector <size_t> & batch) {
+    int64_t K = batch.size();
+    if (K == 0) return;
+    MergeSort(batch, 0, K - 1);
+
+    size_t N = sorted.size();
+    // everything up to the first key bigger than the smallest new key stays put
+    size_t p = std::upper_bound(sorted.begin(), sorted.end(), batch.front(), CountingLess()) - sorted.begin();
+    sorted.resize(N + K);
+    // open a gap of K slots in front of the tail
+    MSORT_MOVE(N - p);
+    std::copy_backward(sorted.begin() + p, sorted.begin() + N, sorted.end());
+
+    size_t * out = sorted.data() + p;
+    size_t * right = out + K;
+    size_t tail = N - p;
+    if (tail >= GALLOP_RATIO * K) {
+        GallopMerge(batch.data(), K, right, right + tail, out);
+    } else {
+        MSORT_COMPARE(K + tail - 1);
+        MSORT_MOVE(K + tail);
+        MergeBitonic(batch.data(), K, right, tail, out);
+    }
+}
+
+/**
+ * Fixes a handful of overwritten slots one at a time. Each dirty slot is
+ * first filled with a copy of its neighbour so the array is sorted again,
+ * then every saved key is binary searched to its place and the slots in
+ * between are shifted by one.
+ * @param arr
+ * @param dirty - sorted, unique, in range
+ */
+static void RepairOneByOne(std::vector <size_t> & arr, std::vector <size_t> & dirty) {
+    size_t K = dirty.size();
+    std::vector <size_t> vals(K);
+    for (size_t i = 0; i < K; i++) {
+        vals[i] = arr[dirty[i]];
+    }
+
+    // leading dirty slots copy the first clean key, the rest their left neighbour
+    size_t lead = 0;
+    while (lead < K && dirty[lead] == lead) lead++;
+    if (lead == arr.size()) {
+        MergeSort(arr, 0, arr.size() - 1);
+        return;
+    }
+    for (size_t i = 0; i < K; i++) {
+        arr[dirty[i]] = (i < lead) ? arr[lead] : arr[dirty[i] - 1];
+    }
+
+    for (size_t i = 0; i < K; i++) {
+        size_t from = dirty[i];
+        size_t to = std::upper_bound(arr.begin(), arr.end(), vals[i]) - arr.begin();
+        if (to > from) {
+            // the placeholder leaves, so the key lands one slot earlier
+            to--;
+            std::copy(arr.begin() + from + 1, arr.begin() + to + 1, arr.begin() + from);
+        } else {
+            std::copy_backward(arr.begin() + to, arr.begin() + from, arr.begin() + from + 1);
+        }
+        arr[to] = vals[i];
+        // placeholders still pending moved along with the shifted block
+        for (size_t j = i + 1; j < K; j++) {
+            if (to > from && dirty[j] > from && dirty[j] <= to) dirty[j]--;
+            else if (to < from && dirty[j] >= to && dirty[j] < from) dirty[j]++;
+        }
+    }
+}
+
+/**
+ * Restores order after the keys at the given positions were overwritten.
+ * Every other key must still be in sorted order.
+ * For a few dirty slots each key is moved directly to its place, which
+ * costs O(k log n) compares and moves only the keys it passes over.
+ * Larger sets are pulled out, sorted and merged back with
+ * MergeInsertBatch.
+ * @param arr
+ * @param dirty - positions that changed, any order, duplicates allowed
+ */
+void RepairSorted(std::vector <size_t> & arr, std::vector <size_t> dirty) {
+    if (dirty.empty()) return;
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    if (dirty.back() >= arr.size()) {
+        throw std::string("dirty position out of range!");
+    }
+
+    if (dirty.size() <= REPAIR_ONE_BY_ONE) {
+        RepairOneByOne(arr, dirty);
+        return;
+    }
+
+    // pull the dirty keys out, closing the holes block by block
+    std::vector <size_t> batch(dirty.size());
+    size_t write = dirty[0];
+    for (size_t i = 0; i < dirty.size(); i++) {
+        batch[i] = arr[dirty[i]];
+        size_t next = (i + 1 < dirty.size()) ? dirty[i + 1] : arr.size();
+        write = std::copy(arr.begin() + dirty[i] + 1, arr.begin() + next, arr.begin() + write) - arr.begin();
+    }
+    arr.resize(write);
+    MergeInsertBatch(arr, batch);
+}
@@ -25,6 +25,7 @@
  */
 
 #include "InsertionSort.hpp"
+#include "SortInstrument.hpp"
 
 /**
  * Function Implementing Insertion Sort
@@ -39,13 +40,15 @@ void InsertionSort(std::vector<size_t>& arr) {
         size_t max = arr[i];
         size_t j = i;
         // Iterate if j is atleast 1 and as long as arr[j-1] is bigger than temp
-        while (j > 0 && arr[j - 1] > max) {
+        while (j > 0 && (MSORT_COMPARE(1), arr[j - 1] > max)) {
             // This is essentially pushing the elements by one
+            MSORT_MOVE(1);
             arr[j] = arr[j-1];
             j -= 1;
         }
         // Finally save the temp to the index where the loop condition
         // was false
+        MSORT_MOVE(j != i);
         arr[j] = max;
     }
 }
@@ -0,0 +1,105 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "MappedSort.hpp"
+#include "QuickSort.hpp"
+#include "HeapSort.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Sorts the mapped keys with the chosen in place algorithm
+ * @param first
+ * @param last
+ * @param algorithm
+ */
+template <typename T>
+static void SortKeys(T * first, T * last, MappedSortAlgorithm algorithm) {
+    if (algorithm == MAPPED_HEAP_SORT) {
+        HeapSort(first, last);
+    } else {
+        QuickSort(first, last);
+    }
+}
+
+size_t SortMappedFile(const std::string & path, size_t keyBytes, MappedSortAlgorithm algorithm) {
+    if (keyBytes != sizeof(uint32_t) && keyBytes != sizeof(uint64_t)) {
+        throw std::string("SortMappedFile: keys must be 4 or 8 bytes");
+    }
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) throw path + ": " + std::strerror(errno);
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        throw path + ": not a regular file";
+    }
+    size_t size = info.st_size;
+    if (size % keyBytes != 0) {
+        close(fd);
+        throw path + ": size is not a multiple of the key size";
+    }
+    if (size == 0) {
+        close(fd);
+        return 0;
+    }
+    void * mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // close may overwrite errno
+    int mapError = errno;
+    // the mapping keeps the file open
+    close(fd);
+    if (mapped == MAP_FAILED) throw path + ": " + std::strerror(mapError);
+
+    // load: every page is needed, start reading all of it now
+    madvise(mapped, size, MADV_WILLNEED);
+    // sort: heap sort jumps around the whole file so read ahead
+    // would be wasted. Quick sort keeps the default, it scans the
+    // same pages O(log n) times and MADV_SEQUENTIAL would let the
+    // kernel drop them behind each scan
+    if (algorithm == MAPPED_HEAP_SORT) madvise(mapped, size, MADV_RANDOM);
+
+    size_t count = size / keyBytes;
+    if (keyBytes == sizeof(uint32_t)) {
+        uint32_t * keys = static_cast<uint32_t *>(mapped);
+        SortKeys(keys, keys + count, algorithm);
+    } else {
+        uint64_t * keys = static_cast<uint64_t *>(mapped);
+        SortKeys(keys, keys + count, algorithm);
+    }
+
+    // write back: the heap sort hint no longer fits, the dirty
+    // pages are flushed front to back
+    if (algorithm == MAPPED_HEAP_SORT) madvise(mapped, size, MADV_NORMAL);
+    int synced = msync(mapped, size, MS_SYNC);
+    int error = errno;
+    munmap(mapped, size);
+    if (synced != 0) throw path + ": msync failed: " + std::strerror(error);
+    return count;
+}
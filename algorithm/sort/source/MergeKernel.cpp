@@ -0,0 +1,297 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "MergeKernel.hpp"
+#include <algorithm>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define MERGE_HAVE_X86_SIMD 1
+#include <immintrin.h>
+// GCC's _mm512_undefined_* self initialise on purpose and trip
+// -Wuninitialized once inlined into optimised code
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+/**
+ * Merges the sorted runs left[0, N1) and right[0, N2) into out.
+ * The next element is picked with a conditional move and both cursors
+ * are advanced arithmetically, so there is no data dependent branch in
+ * the loop and nothing for the predictor to miss on random input.
+ * Ties are taken from the left run, so the merge is stable.
+ *
+ * out may alias the slots right before right, i.e. out + N1 == right.
+ * The output can never overtake the unread part of the right run in that
+ * case, which lets callers copy out only the left run.
+ * TC - O(N1 + N2)
+ * @param left
+ * @param N1
+ * @param right
+ * @param N2
+ * @param out
+ * @return one past the last element written
+ */
+size_t * MergeBranchless(const size_t * left, size_t N1, const size_t * right, size_t N2, size_t * out) {
+    const size_t * leftEnd = left + N1;
+    const size_t * rightEnd = right + N2;
+
+    while (left < leftEnd && right < rightEnd) {
+        size_t l = *left;
+        size_t r = *right;
+        bool takeRight = r < l;
+        *out++ = takeRight ? r : l;
+        left += !takeRight;
+        right += takeRight;
+    }
+
+    out = std::copy(left, leftEnd, out);
+    // when merging in place the rest of the right run is already there
+    if (out != right) {
+        out = std::copy(right, rightEnd, out);
+    } else {
+        out += rightEnd - right;
+    }
+    return out;
+}
+
+/**
+ * Merges what is left once a vector loop stops: the W keys still held in
+ * the register (spilled to tail) and the remainders of both runs. One of
+ * the remainders is shorter than W, so it is merged with the spilled keys
+ * on the stack first and the result is merged with the long remainder.
+ * @param tail - W sorted keys, none smaller than anything already written
+ * @param W
+ * @param left
+ * @param N1
+ * @param right
+ * @param N2
+ * @param out
+ * @return one past the last element written
+ */
+static size_t * MergeTail(const size_t * tail, size_t W, const size_t * left, size_t N1,
+        const size_t * right, size_t N2, size_t * out) {
+    // W + W - 1 keys at most, W is never above 8
+    size_t small[16];
+    if (N1 < W) {
+        size_t * end = MergeBranchless(tail, W, left, N1, small);
+        // small now plays the left run, keeping the in place aliasing valid
+        return MergeBranchless(small, end - small, right, N2, out);
+    }
+    size_t * end = MergeBranchless(tail, W, right, N2, small);
+    return MergeBranchless(left, N1, small, end - small, out);
+}
+
+#ifdef MERGE_HAVE_X86_SIMD
+
+/*
+ * AVX2 has no unsigned 64 bit compare. Keys get their sign bit flipped
+ * on load and back on store, so the signed compare orders them right and
+ * the flip stays out of the merge network.
+ */
+__attribute__((target("avx2")))
+static inline __m256i FlipSign4(__m256i x) {
+    return _mm256_xor_si256(x, _mm256_set1_epi64x((long long) 0x8000000000000000ULL));
+}
+
+__attribute__((target("avx2")))
+static inline void MinMax4(__m256i a, __m256i b, __m256i & mn, __m256i & mx) {
+    __m256i gt = _mm256_cmpgt_epi64(a, b);
+    mn = _mm256_blendv_epi8(a, b, gt);
+    mx = _mm256_blendv_epi8(b, a, gt);
+}
+
+/*
+ * Sorts a bitonic sequence of 4 keys held in one register with the two
+ * half cleaner steps (distance 2, then distance 1).
+ */
+__attribute__((target("avx2")))
+static inline __m256i BitonicClean4(__m256i x) {
+    __m256i mn, mx;
+    MinMax4(x, _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 3, 2)), mn, mx);
+    x = _mm256_blend_epi32(mn, mx, 0xF0);
+    MinMax4(x, _mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 3, 0, 1)), mn, mx);
+    return _mm256_blend_epi32(mn, mx, 0xCC);
+}
+
+/*
+ * Merges two sorted registers of 4 keys: lo gets the 4 smallest and hi
+ * the 4 largest, both sorted.
+ */
+__attribute__((target("avx2")))
+static inline void BitonicMerge4(__m256i a, __m256i b, __m256i & lo, __m256i & hi) {
+    // a followed by reversed b is bitonic
+    b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 1, 2, 3));
+    MinMax4(a, b, lo, hi);
+    lo = BitonicClean4(lo);
+    hi = BitonicClean4(hi);
+}
+
+/**
+ * Streaming bitonic merge, 4 keys per step with AVX2.
+ * One register always holds the 4 largest keys seen so far, the other is
+ * refilled from whichever run has the smaller next key. Keys written
+ * lag the keys loaded by one register, so out may alias the slots in
+ * front of right just like MergeBranchless.
+ */
+__attribute__((target("avx2")))
+static size_t * MergeAVX2(const size_t * left, size_t N1, const size_t * right, size_t N2, size_t * out) {
+    const size_t W = 4;
+    const size_t * leftEnd = left + N1;
+    const size_t * rightEnd = right + N2;
+    __m256i hi = FlipSign4(_mm256_loadu_si256((const __m256i *) left));
+    __m256i next = FlipSign4(_mm256_loadu_si256((const __m256i *) right));
+    left += W;
+    right += W;
+
+    while (true) {
+        __m256i lo;
+        BitonicMerge4(next, hi, lo, hi);
+        _mm256_storeu_si256((__m256i *) out, FlipSign4(lo));
+        out += W;
+
+        // once a run is down to its last partial register, finish in scalar
+        if ((size_t) (leftEnd - left) < W || (size_t) (rightEnd - right) < W) break;
+        // refill from the run with the smaller head, selected without a branch
+        bool fromLeft = *left <= *right;
+        next = FlipSign4(_mm256_loadu_si256((const __m256i *) (fromLeft ? left : right)));
+        left += fromLeft ? W : 0;
+        right += fromLeft ? 0 : W;
+    }
+
+    size_t tail[W];
+    _mm256_storeu_si256((__m256i *) tail, FlipSign4(hi));
+    return MergeTail(tail, W, left, leftEnd - left, right, rightEnd - right, out);
+}
+
+/*
+ * Sorts a bitonic sequence of 8 keys held in one register.
+ * AVX-512 has native unsigned 64 bit min and max.
+ */
+__attribute__((target("avx512f")))
+static inline __m512i BitonicClean8(__m512i x) {
+    const __m512i swap4 = _mm512_set_epi64(3, 2, 1, 0, 7, 6, 5, 4);
+    const __m512i swap2 = _mm512_set_epi64(5, 4, 7, 6, 1, 0, 3, 2);
+    const __m512i swap1 = _mm512_set_epi64(6, 7, 4, 5, 2, 3, 0, 1);
+    __m512i y = _mm512_permutexvar_epi64(swap4, x);
+    x = _mm512_mask_blend_epi64(0xF0, _mm512_min_epu64(x, y), _mm512_max_epu64(x, y));
+    y = _mm512_permutexvar_epi64(swap2, x);
+    x = _mm512_mask_blend_epi64(0xCC, _mm512_min_epu64(x, y), _mm512_max_epu64(x, y));
+    y = _mm512_permutexvar_epi64(swap1, x);
+    return _mm512_mask_blend_epi64(0xAA, _mm512_min_epu64(x, y), _mm512_max_epu64(x, y));
+}
+
+/*
+ * Merges two sorted registers of 8 keys into the 8 smallest (lo) and
+ * the 8 largest (hi).
+ */
+__attribute__((target("avx512f")))
+static inline void BitonicMerge8(__m512i a, __m512i b, __m512i & lo, __m512i & hi) {
+    const __m512i reverse = _mm512_set_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    b = _mm512_permutexvar_epi64(reverse, b);
+    lo = BitonicClean8(_mm512_min_epu64(a, b));
+    hi = BitonicClean8(_mm512_max_epu64(a, b));
+}
+
+/**
+ * Same streaming loop as MergeAVX2, 8 keys per step.
+ */
+__attribute__((target("avx512f")))
+static size_t * MergeAVX512(const size_t * left, size_t N1, const size_t * right, size_t N2, size_t * out) {
+    const size_t W = 8;
+    const size_t * leftEnd = left + N1;
+    const size_t * rightEnd = right + N2;
+    __m512i hi = _mm512_loadu_si512((const void *) left);
+    __m512i next = _mm512_loadu_si512((const void *) right);
+    left += W;
+    right += W;
+
+    while (true) {
+        __m512i lo;
+        BitonicMerge8(next, hi, lo, hi);
+        _mm512_storeu_si512((void *) out, lo);
+        out += W;
+
+        // once a run is down to its last partial register, finish in scalar
+        if ((size_t) (leftEnd - left) < W || (size_t) (rightEnd - right) < W) break;
+        // refill from the run with the smaller head, selected without a branch
+        bool fromLeft = *left <= *right;
+        next = _mm512_loadu_si512((const void *) (fromLeft ? left : right));
+        left += fromLeft ? W : 0;
+        right += fromLeft ? 0 : W;
+    }
+
+    size_t tail[W];
+    _mm512_storeu_si512((void *) tail, hi);
+    return MergeTail(tail, W, left, leftEnd - left, right, rightEnd - right, out);
+}
+
+#endif /* MERGE_HAVE_X86_SIMD */
+
+/**
+ * Widest merge kernel this CPU can run, looked up once
+ * @return
+ */
+MergeIsa MergeIsaSupported() {
+#ifdef MERGE_HAVE_X86_SIMD
+    static const MergeIsa best = __builtin_cpu_supports("avx512f") ? MERGE_ISA_AVX512 :
+            __builtin_cpu_supports("avx2") ? MERGE_ISA_AVX2 : MERGE_ISA_SCALAR;
+    return best;
+#else
+    return MERGE_ISA_SCALAR;
+#endif
+}
+
+/**
+ * Merges the sorted runs left[0, N1) and right[0, N2) into out using a
+ * bitonic merge network on SIMD registers, several keys per step. Falls
+ * back to MergeBranchless when the CPU has no AVX2 or a run is shorter
+ * than one register. Equal keys are indistinguishable so stability does
+ * not matter here. Same aliasing rules as MergeBranchless.
+ * TC - O(N1 + N2)
+ * @param left
+ * @param N1
+ * @param right
+ * @param N2
+ * @param out
+ * @param isa - widest instruction set to use, MERGE_ISA_AUTO picks the best
+ * @return one past the last element written
+ */
+size_t * MergeBitonic(const size_t * left, size_t N1, const size_t * right, size_t N2, size_t * out,
+        MergeIsa isa) {
+    MergeIsa supported = MergeIsaSupported();
+    if (isa == MERGE_ISA_AUTO || isa > supported) {
+        isa = supported;
+    }
+#ifdef MERGE_HAVE_X86_SIMD
+    if (isa == MERGE_ISA_AVX512 && N1 >= 8 && N2 >= 8) {
+        return MergeAVX512(left, N1, right, N2, out);
+    }
+    if (isa >= MERGE_ISA_AVX2 && N1 >= 4 && N2 >= 4) {
+        return MergeAVX2(left, N1, right, N2, out);
+    }
+#endif
+    return MergeBranchless(left, N1, right, N2, out);
+}
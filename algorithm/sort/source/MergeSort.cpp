@@ -25,58 +25,56 @@
  */
 
 #include "MergeSort.hpp"
+#include "MergeKernel.hpp"
+#include "SortInstrument.hpp"
 #include <algorithm>
 
 
 /**
  * This a private helper function which does the merge and sort
- * TC - O(N1) + O(N2) + O(N1 + N2) ~= O(n) 
+ * TC - O(N1) + O(N1 + N2) ~= O(n) 
  * WC complexity is O(n) when high - low = n
  * @param arr
  * @param low
+ * @param mid
  * @param high
+ * @param buf - scratch space of at least mid + 1 - low elements
  */
-static void Merge(std::vector <size_t> & arr, const int64_t &low, const int64_t &mid, const int64_t &high) {
+static void Merge(std::vector <size_t> & arr, const int64_t &low, const int64_t &mid, const int64_t &high,
+        std::vector <size_t> & buf) {
+    // Runs are already in order, nothing to merge
+    MSORT_COMPARE(1);
+    if (arr[mid] <= arr[mid + 1]) return;
+
     int64_t N1 = mid + 1 - low;
     int64_t N2 = high - mid;
-    // We need to copy the data to temp left and right arrays before merging.
-    // Merge is not an in place algorithm
-    int64_t L[N1], R[N2];
+    // Merge is not an in place algorithm, but only the left run has to
+    // be copied out. The right run is merged from where it already is.
     // O(N1)
-    for (int64_t i = 0; i < N1; i++) {
-        L[i] = arr[i + low]; 
-    }
-    
-    // O(N2)
-    for (int64_t i = 0; i < N2; i++) {
-        R[i] = arr[i + mid + 1];
-    }
-    int64_t i = 0;
-    int64_t j = 0;
-    // This should start from low
-    int64_t k = low;
-    // Merge O(N1 + N2)
-    while ( i < N1 && j < N2) {
-        if (L[i] < R[j]) {
-            arr[k] = L[i];
-            i++;
-        } else {
-            arr[k] = R[j];
-            j++;
-        }
-        k++;
-    }
-    
-    while (i < N1) {
-        arr[k] = L[i];
-        k++;
-        i++;
-    }
-    
-    while (j < N2) {
-        arr[k] = R[j];
-        k++;
-        j++; 
+    std::copy(arr.begin() + low, arr.begin() + mid + 1, buf.begin());
+    // Merge O(N1 + N2), the kernel compares about once per output key
+    MSORT_MOVE(N1 + N1 + N2);
+    MSORT_COMPARE(N1 + N2 - 1);
+    MergeBitonic(buf.data(), N1, arr.data() + mid + 1, N2, arr.data() + low);
+}
+
+/**
+ * Recursive worker for MergeSort, shares one scratch buffer across
+ * all the merges instead of allocating per call
+ * @param arr
+ * @param low
+ * @param high
+ * @param buf
+ */
+static void MergeSortRecursive(std::vector <size_t> & arr, const int64_t & low, const int64_t & high,
+        std::vector <size_t> & buf) {
+    MSORT_DEPTH();
+    if (high > low) {
+        int64_t mid = (low + high)/2;
+        MergeSortRecursive(arr, low, mid, buf);
+        MergeSortRecursive(arr, mid + 1, high, buf);
+        // this is called approx log(n) times
+        Merge(arr, low, mid, high, buf);
     }
 }
 
@@ -90,11 +88,10 @@ static void Merge(std::vector <size_t> & arr, const int64_t &low, const int64_t
  */
 void MergeSort(std::vector <size_t> & arr, const int64_t & low, const int64_t & high) {
     if (high > low) {
-        int64_t mid = (low + high)/2;
-        MergeSort(arr, low, mid);
-        MergeSort(arr, mid + 1, high);
-        // this is called approx log(n) times
-        Merge(arr, low, mid, high);
+        // the biggest left run is the first half
+        std::vector <size_t> buf((high - low)/2 + 1);
+        MSORT_AUX(buf.size() * sizeof(size_t));
+        MergeSortRecursive(arr, low, high, buf);
     }
 }
 
@@ -105,13 +102,18 @@ void MergeSort(std::vector <size_t> & arr, const int64_t & low, const int64_t &
  * @param high
  */
 void MergeSortIterative(std::vector <size_t> & arr, const int64_t & low, const int64_t & high) {
-    
+    if (high <= low) return;
+    std::vector <size_t> buf(high - low);
+    MSORT_AUX(buf.size() * sizeof(size_t));
+
     for (int64_t i = 1; i <= (high - low); i *= 2) {
-        for (int64_t left_end = 0; left_end < (high - low); left_end += 2*i) {
-            int64_t mid = std::min(left_end + i - 1, high - low);
-            int64_t right_end = std::min (left_end + 2*i - 1, high - low);
+        for (int64_t left_end = low; left_end < high; left_end += 2*i) {
+            int64_t mid = std::min(left_end + i - 1, high);
+            int64_t right_end = std::min (left_end + 2*i - 1, high);
             // this is called approx log(n) times
-            Merge(arr, left_end, mid, right_end);
+            if (mid < right_end) {
+                Merge(arr, left_end, mid, right_end, buf);
+            }
         }
     }
 }
@@ -26,6 +26,9 @@
 
 #include <algorithm>
 #include "QuickSort.hpp"
+#include "SortInstrument.hpp"
+#include "InsertionSort.hpp"
+#include "HeapSort.hpp"
 #include <stack>
 /**
  *  Helper partition function
@@ -42,12 +45,15 @@ static int64_t Partition(std::vector<size_t> & arr, const int64_t & low, const i
     // all the elements to the left of pivot are larger
     // than pivot. This implies that pivot gets moves to its
     // original position after the loop gets over. O(n)
+    MSORT_COMPARE(high - low);
     for (int64_t j = low; j < high ; j++) {
         if ( arr[j] < pivot ) {
+            MSORT_SWAP(1);
             std::swap(arr[++i], arr[j]);
         }
     }
     // i+1 would be the new index of pivot
+    MSORT_SWAP(1);
     std::swap(arr[high], arr[i+1]);
     return i + 1;
 }
@@ -59,6 +65,7 @@ static int64_t Partition(std::vector<size_t> & arr, const int64_t & low, const i
  * @param high - highest index
  */
 void QuickSort(std::vector <size_t> & arr, const int64_t & low, const int64_t & high) {
+    MSORT_DEPTH();
     if (low < high) {
         int64_t p = Partition(arr, low, high);
         //This is supposed to be log(n) operation
@@ -86,5 +93,218 @@ void QuickSortIterative(std::vector<size_t>& arr, const int64_t & low, const int
         int64_t p = Partition(arr, start, end);
         if (p - 1 > start) rangeStack.push(std::make_pair(start, p - 1));
         if (end > p + 1) rangeStack.push(std::make_pair(p + 1, end));
+        // the explicit stack stands in for the recursion
+        MSORT_MAX_DEPTH(rangeStack.size());
     }
 }
+
+// Ranges this small are finished with insertion sort
+static const int64_t DUAL_PIVOT_CUTOFF = 17;
+
+/**
+ * Picks the 2nd and 4th of five evenly spaced samples as the two pivots
+ * and parks them at low and high. Taking them from the tertiles keeps
+ * sorted and reverse sorted input from degrading to O(n^2).
+ * @param arr
+ * @param low
+ * @param high
+ */
+static void ChoosePivots(std::vector <size_t> & arr, const int64_t & low, const int64_t & high) {
+    int64_t step = (high - low) / 6;
+    int64_t s[5] = { low + step, low + 2*step, low + 3*step, low + 4*step, low + 5*step };
+    // insertion sort of the five samples in place
+    for (int i = 1; i < 5; i++) {
+        for (int j = i; j > 0 && (MSORT_COMPARE(1), arr[s[j]] < arr[s[j - 1]]); j--) {
+            MSORT_SWAP(1);
+            std::swap(arr[s[j]], arr[s[j - 1]]);
+        }
+    }
+    MSORT_SWAP(2);
+    std::swap(arr[low], arr[s[1]]);
+    std::swap(arr[high], arr[s[3]]);
+}
+
+/**
+ * Yaroslavskiy dual pivot partition. With pivots p <= q the range ends
+ * up as [< p | p | p <= x <= q | q | > q] after a single pass.
+ * @param arr
+ * @param low
+ * @param high
+ * @param lp - final index of p
+ * @param rp - final index of q
+ */
+static void DualPivotPartition(std::vector <size_t> & arr, const int64_t & low, const int64_t & high,
+        int64_t & lp, int64_t & rp) {
+    MSORT_COMPARE(1);
+    if (arr[low] > arr[high]) {
+        MSORT_SWAP(1);
+        std::swap(arr[low], arr[high]);
+    }
+    size_t p = arr[low];
+    size_t q = arr[high];
+    // [low+1, l) < p, [l, k) in [p, q], (g, high) > q, [k, g] not seen yet
+    int64_t l = low + 1, k = low + 1, g = high - 1;
+    while (k <= g) {
+        MSORT_COMPARE(1);
+        if (arr[k] < p) {
+            MSORT_SWAP(1);
+            std::swap(arr[k], arr[l]);
+            l++;
+        } else if (MSORT_COMPARE(1), arr[k] > q) {
+            while ((MSORT_COMPARE(1), arr[g] > q) && k < g) g--;
+            MSORT_SWAP(1);
+            std::swap(arr[k], arr[g]);
+            g--;
+            MSORT_COMPARE(1);
+            if (arr[k] < p) {
+                MSORT_SWAP(1);
+                std::swap(arr[k], arr[l]);
+                l++;
+            }
+        }
+        k++;
+    }
+    l--;
+    g++;
+    // move the pivots to their final place
+    MSORT_SWAP(2);
+    std::swap(arr[low], arr[l]);
+    std::swap(arr[high], arr[g]);
+    lp = l;
+    rp = g;
+}
+
+/**
+ * @param N
+ * @return 2 log2(N), the partitions allowed before heap sort takes over
+ */
+static int DepthLimit(size_t N) {
+    int depth = 0;
+    while (N > 1) {
+        N >>= 1;
+        depth += 2;
+    }
+    return depth;
+}
+
+/**
+ * Dual pivot quick sort loop. Each pass splits the range into three parts
+ * around two pivots, touching memory fewer times than the single pivot
+ * Lomuto scheme. The two smaller parts are sorted recursively and the
+ * biggest one by looping, which bounds the stack at O(log n).
+ * @param arr - array to be sorted in place
+ * @param low - lowest index
+ * @param high - highest index
+ * @param depthLimit - partitions left before switching to heap sort
+ */
+static void DualPivotQuickSortRange(std::vector <size_t> & arr, int64_t lo, int64_t hi, int depthLimit) {
+    MSORT_DEPTH();
+    while (hi - lo >= DUAL_PIVOT_CUTOFF) {
+        if (depthLimit-- == 0) {
+            // the sampled pivots keep splitting badly, heap sort stays O(n log n)
+            HeapSort(arr.data() + lo, arr.data() + hi + 1);
+            return;
+        }
+        ChoosePivots(arr, lo, hi);
+        int64_t lp, rp;
+        DualPivotPartition(arr, lo, hi, lp, rp);
+
+        int64_t start[3] = { lo, lp + 1, rp + 1 };
+        int64_t end[3] = { lp - 1, rp - 1, hi };
+        // equal pivots leave only copies of the pivot in the middle
+        if (arr[lp] == arr[rp]) end[1] = start[1] - 1;
+
+        int biggest = 0;
+        for (int i = 1; i < 3; i++) {
+            if (end[i] - start[i] > end[biggest] - start[biggest]) biggest = i;
+        }
+        for (int i = 0; i < 3; i++) {
+            if (i != biggest) DualPivotQuickSortRange(arr, start[i], end[i], depthLimit);
+        }
+        lo = start[biggest];
+        hi = end[biggest];
+    }
+
+    for (int64_t i = lo + 1; i <= hi; i++) {
+        size_t temp = arr[i];
+        int64_t j = i;
+        while (j > lo && (MSORT_COMPARE(1), arr[j - 1] > temp)) {
+            MSORT_MOVE(1);
+            arr[j] = arr[j - 1];
+            j--;
+        }
+        MSORT_MOVE(j != i);
+        arr[j] = temp;
+    }
+}
+
+/**
+ * Dual pivot quick sort, falling back to heap sort when the recursion
+ * gets deeper than 2 log2(n) partitions.
+ * @param arr - array to be sorted in place
+ * @param low - lowest index
+ * @param high - highest index
+ */
+void DualPivotQuickSort(std::vector <size_t> & arr, const int64_t & low, const int64_t & high) {
+    if (high <= low) return;
+    DualPivotQuickSortRange(arr, low, high, DepthLimit(high - low + 1));
+}
+
+// Ranges this small are finished with binary insertion sort
+static const ptrdiff_t RANGE_CUTOFF = 16;
+
+/**
+ * Introsort loop of the pointer QuickSort. The smaller side is sorted
+ * recursively and the bigger one by looping.
+ * @param first
+ * @param last
+ * @param depthLimit - partitions left before switching to heap sort
+ */
+template <typename T>
+static void QuickSortRange(T * first, T * last, int depthLimit) {
+    MSORT_DEPTH();
+    while (last - first > RANGE_CUTOFF) {
+        if (depthLimit-- == 0) {
+            // the pivots keep splitting badly, heap sort stays O(n log n)
+            HeapSort(first, last);
+            return;
+        }
+        T a = first[0], b = first[(last - first) / 2], c = last[-1];
+        MSORT_COMPARE(3);
+        T pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+        // Hoare partition: equal keys stop both scans, so duplicates split evenly
+        T * i = first - 1;
+        T * j = last;
+        for (;;) {
+            do {
+                i++;
+                MSORT_COMPARE(1);
+            } while (*i < pivot);
+            do {
+                j--;
+                MSORT_COMPARE(1);
+            } while (pivot < *j);
+            if (i >= j) break;
+            MSORT_SWAP(1);
+            std::swap(*i, *j);
+        }
+        T * middle = j + 1;
+        if (middle - first < last - middle) {
+            QuickSortRange(first, middle, depthLimit);
+            first = middle;
+        } else {
+            QuickSortRange(middle, last, depthLimit);
+            last = middle;
+        }
+    }
+    BinaryInsertionSort(first, last);
+}
+
+void QuickSort(uint32_t * first, uint32_t * last) {
+    QuickSortRange(first, last, DepthLimit(last - first));
+}
+
+void QuickSort(uint64_t * first, uint64_t * last) {
+    QuickSortRange(first, last, DepthLimit(last - first));
+}
@@ -0,0 +1,277 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "RadixSort.hpp"
+#include "SortInstrument.hpp"
+#include <cstring>
+#include <cstddef>
+#include <string>
+#include <algorithm>
+
+/**
+ * Moves every record of src to its bucket slot in dst for one digit.
+ * The record size is a template parameter for the common sizes so the
+ * copy compiles down to a couple of plain moves.
+ * @param src
+ * @param dst
+ * @param count
+ * @param recordSize
+ * @param digit - byte offset of the digit inside a record
+ * @param offsets - 256 running bucket positions
+ */
+template <size_t Size>
+static void ScatterPass(const unsigned char * src, unsigned char * dst, size_t count,
+        size_t recordSize, size_t digit, size_t * offsets) {
+    const size_t size = Size ? Size : recordSize;
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char * rec = src + i * size;
+        std::memcpy(dst + offsets[rec[digit]]++ * size, rec, size);
+    }
+}
+
+// Above this many bytes a range is split on its top digit first so that
+// the LSD passes run on cache sized buckets
+static const size_t MSD_SPLIT_BYTES = 1 << 20;
+// Ranges needing more LSD passes than this are split on the top digit too
+static const size_t LSD_MAX_PASSES = 4;
+// Buckets this small are finished with insertion sort
+static const size_t RADIX_INSERTION_CUTOFF = 64;
+
+/**
+ * Byte histogram of one digit over count records
+ * @param data
+ * @param count
+ * @param recordSize
+ * @param digit
+ * @param bucket - 256 counters, zeroed here
+ */
+static void Histogram(const unsigned char * data, size_t count, size_t recordSize, size_t digit,
+        size_t * bucket) {
+    std::fill(bucket, bucket + 256, 0);
+    for (size_t i = 0; i < count; i++) {
+        bucket[data[i * recordSize + digit]]++;
+    }
+}
+
+/**
+ * Turns counts into bucket start positions
+ * @param bucket
+ */
+static void PrefixSum(size_t * bucket) {
+    size_t sum = 0;
+    for (size_t b = 0; b < 256; b++) {
+        size_t c = bucket[b];
+        bucket[b] = sum;
+        sum += c;
+    }
+}
+
+/**
+ * One stable scatter pass by digit, picking the copy size at compile
+ * time for the common record sizes
+ */
+static void Scatter(const unsigned char * src, unsigned char * dst, size_t count,
+        size_t recordSize, size_t digit, size_t * offsets) {
+    switch (recordSize) {
+    case 8:  ScatterPass<8>(src, dst, count, recordSize, digit, offsets); break;
+    case 16: ScatterPass<16>(src, dst, count, recordSize, digit, offsets); break;
+    case 24: ScatterPass<24>(src, dst, count, recordSize, digit, offsets); break;
+    case 32: ScatterPass<32>(src, dst, count, recordSize, digit, offsets); break;
+    default: ScatterPass<0>(src, dst, count, recordSize, digit, offsets); break;
+    }
+}
+
+/**
+ * Orders two records by digits[0, nd), most significant (last) first
+ */
+static bool RecordLess(const unsigned char * a, const unsigned char * b, const size_t * digits, size_t nd) {
+    for (size_t d = nd; d-- > 0;) {
+        if (a[digits[d]] != b[digits[d]]) return a[digits[d]] < b[digits[d]];
+    }
+    return false;
+}
+
+/**
+ * Stable insertion sort for the tiny buckets left over by the MSD split
+ * @param data
+ * @param temp - room for one record
+ */
+static void InsertionSortRecords(unsigned char * data, unsigned char * temp, size_t count, size_t recordSize,
+        const size_t * digits, size_t nd) {
+    for (size_t i = 1; i < count; i++) {
+        size_t j = i;
+        while (j > 0 && (MSORT_COMPARE(1), RecordLess(data + i * recordSize, data + (j - 1) * recordSize, digits, nd))) j--;
+        if (j == i) continue;
+        MSORT_MOVE(i - j + 1);
+        std::memcpy(temp, data + i * recordSize, recordSize);
+        std::memmove(data + (j + 1) * recordSize, data + j * recordSize, (i - j) * recordSize);
+        std::memcpy(data + j * recordSize, temp, recordSize);
+    }
+}
+
+/**
+ * One LSD pass per digit over a cache sized range, all histograms built
+ * in a single read. Constant digits are skipped.
+ * @param data - records, sorted in place
+ * @param scratch - same size as data
+ * @param count
+ * @param recordSize
+ * @param digits
+ * @param nd - at most LSD_MAX_PASSES
+ */
+static void LsdSort(unsigned char * data, unsigned char * scratch, size_t count, size_t recordSize,
+        const size_t * digits, size_t nd) {
+    size_t counts[LSD_MAX_PASSES * 256] = { 0 };
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char * rec = data + i * recordSize;
+        for (size_t d = 0; d < nd; d++) {
+            counts[d * 256 + rec[digits[d]]]++;
+        }
+    }
+
+    unsigned char * src = data;
+    unsigned char * dst = scratch;
+    for (size_t d = 0; d < nd; d++) {
+        size_t * offsets = &counts[d * 256];
+        if (offsets[src[digits[d]]] == count) continue;
+        PrefixSum(offsets);
+        MSORT_MOVE(count);
+        Scatter(src, dst, count, recordSize, digits[d], offsets);
+        std::swap(src, dst);
+    }
+    if (src != data) {
+        MSORT_MOVE(count);
+        std::memcpy(data, src, count * recordSize);
+    }
+}
+
+/**
+ * Sorts the records in data by digits[0, nd), least significant first.
+ * Big ranges, or ranges with many digits left, are split by their most
+ * significant digit (MSD) and every bucket is sorted on its own. Cache
+ * sized ranges with a few digits left get LSD passes and tiny ones an
+ * insertion sort. Leading digits whose byte is the same in every record
+ * are dropped before splitting; on big ranges their histograms all come
+ * from a single read.
+ * @param data - records, sorted in place
+ * @param scratch - same size as data
+ * @param count
+ * @param recordSize
+ * @param digits
+ * @param nd
+ */
+static void SortDigits(unsigned char * data, unsigned char * scratch, size_t count, size_t recordSize,
+        const size_t * digits, size_t nd) {
+    MSORT_DEPTH();
+    if (count < 2 || nd == 0) return;
+    if (count <= RADIX_INSERTION_CUTOFF) {
+        InsertionSortRecords(data, scratch, count, recordSize, digits, nd);
+        return;
+    }
+    bool big = count * recordSize > MSD_SPLIT_BYTES;
+    if (!big && nd <= LSD_MAX_PASSES) {
+        LsdSort(data, scratch, count, recordSize, digits, nd);
+        return;
+    }
+
+    size_t bucket[256];
+    if (big) {
+        std::vector <size_t> counts(nd * 256);
+        for (size_t i = 0; i < count; i++) {
+            const unsigned char * rec = data + i * recordSize;
+            for (size_t d = 0; d < nd; d++) {
+                counts[d * 256 + rec[digits[d]]]++;
+            }
+        }
+        while (nd > 0 && counts[(nd - 1) * 256 + data[digits[nd - 1]]] == count) nd--;
+        if (nd == 0) return;
+        std::copy(counts.begin() + (nd - 1) * 256, counts.begin() + nd * 256, bucket);
+    } else {
+        while (true) {
+            Histogram(data, count, recordSize, digits[nd - 1], bucket);
+            if (bucket[data[digits[nd - 1]]] != count) break;
+            if (--nd == 0) return;
+        }
+    }
+
+    size_t top = nd - 1;
+    size_t sizes[256];
+    std::copy(bucket, bucket + 256, sizes);
+    PrefixSum(bucket);
+    MSORT_MOVE(2 * count);
+    Scatter(data, scratch, count, recordSize, digits[top], bucket);
+    std::memcpy(data, scratch, count * recordSize);
+    size_t start = 0;
+    for (size_t b = 0; b < 256; b++) {
+        size_t offset = start * recordSize;
+        SortDigits(data + offset, scratch + offset, sizes[b], recordSize, digits, top);
+        start += sizes[b];
+    }
+}
+
+/**
+ * Radix sort of count records, recordSize bytes each, by the given key
+ * fields. Stable. Needs count * recordSize bytes of scratch space.
+ * TC - O(d * n) for d key bytes, less when digits are constant
+ * @param base
+ * @param count
+ * @param recordSize
+ * @param fields - most significant first
+ */
+void RadixSortRecords(void * base, size_t count, size_t recordSize,
+        const std::vector <RadixKeyField> & fields) {
+    // byte offsets of all digits, least significant first
+    std::vector <size_t> digits;
+    for (size_t f = fields.size(); f-- > 0;) {
+        const RadixKeyField & field = fields[f];
+        if (field.width == 0 || field.offset + field.width > recordSize
+                || (!field.bytewise && field.width > 8)) {
+            throw std::string("radix key field does not fit the record!");
+        }
+        for (size_t b = 0; b < field.width; b++) {
+            // little endian integers have their low byte first,
+            // bytewise fields their least significant byte last
+            digits.push_back(field.offset + (field.bytewise ? field.width - 1 - b : b));
+        }
+    }
+    if (count < 2 || digits.empty()) return;
+
+    std::vector <unsigned char> scratch(count * recordSize);
+    MSORT_AUX(scratch.size());
+    SortDigits((unsigned char *) base, scratch.data(), count, recordSize, digits.data(), digits.size());
+}
+
+/**
+ * Radix sort of 128 bit keys by hi, then lo
+ * @param arr
+ */
+void RadixSort128(std::vector <Key128> & arr) {
+    static const std::vector <RadixKeyField> fields {
+        RadixKeyField(offsetof(Key128, hi), 8),
+        RadixKeyField(offsetof(Key128, lo), 8)
+    };
+    RadixSortRecords(arr, fields);
+}
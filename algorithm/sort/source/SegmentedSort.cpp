@@ -0,0 +1,213 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SegmentedSort.hpp"
+#include "SortInstrument.hpp"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <functional>
+
+// Segments up to this size go straight to insertion sort
+static const int64_t INSERTION_CUTOFF = 24;
+// Below this many keys in total threads cost more than they save
+static const size_t PARALLEL_MIN_KEYS = 1 << 16;
+
+/**
+ * Plain insertion sort on [first, last)
+ * @param first
+ * @param last
+ */
+static void SmallInsertionSort(size_t * first, size_t * last) {
+    for (size_t * i = first + 1; i < last; i++) {
+        size_t temp = *i;
+        size_t * j = i;
+        while (j > first && (MSORT_COMPARE(1), *(j - 1) > temp)) {
+            MSORT_MOVE(1);
+            *j = *(j - 1);
+            j--;
+        }
+        MSORT_MOVE(j != i);
+        *j = temp;
+    }
+}
+
+/**
+ * Moves the median of a, b and c to result
+ * @param result
+ * @param a
+ * @param b
+ * @param c
+ */
+static void MoveMedianToFirst(size_t * result, size_t * a, size_t * b, size_t * c) {
+    MSORT_COMPARE(3);
+    MSORT_SWAP(1);
+    if (*a < *b) {
+        if (*b < *c) std::swap(*result, *b);
+        else if (*a < *c) std::swap(*result, *c);
+        else std::swap(*result, *a);
+    } else if (*a < *c) {
+        std::swap(*result, *a);
+    } else if (*b < *c) {
+        std::swap(*result, *c);
+    } else {
+        std::swap(*result, *b);
+    }
+}
+
+/**
+ * Hoare partition around the median of three, which is parked at first.
+ * The median guarantees a stopper on both sides, so the inner scans
+ * need no bounds checks.
+ * @param first
+ * @param last
+ * @return start of the upper part
+ */
+static size_t * PartitionPivot(size_t * first, size_t * last) {
+    MoveMedianToFirst(first, first + 1, first + (last - first)/2, last - 1);
+    size_t * lo = first + 1;
+    size_t * hi = last;
+    while (true) {
+        while ((MSORT_COMPARE(1), *lo < *first)) lo++;
+        hi--;
+        while ((MSORT_COMPARE(1), *first < *hi)) hi--;
+        if (!(lo < hi)) return lo;
+        MSORT_SWAP(1);
+        std::swap(*lo, *hi);
+        lo++;
+    }
+}
+
+/**
+ * Introsort loop, leaves ranges of INSERTION_CUTOFF or less unsorted
+ * for the final insertion pass and falls back to heap sort once the
+ * depth budget is used up
+ * @param first
+ * @param last
+ * @param depth
+ */
+static void IntroSortLoop(size_t * first, size_t * last, int depth) {
+    MSORT_DEPTH();
+    while (last - first > INSERTION_CUTOFF) {
+        if (depth == 0) {
+            std::make_heap(first, last, CountingLess());
+            std::sort_heap(first, last, CountingLess());
+            return;
+        }
+        depth--;
+        size_t * cut = PartitionPivot(first, last);
+        IntroSortLoop(cut, last, depth);
+        last = cut;
+    }
+}
+
+/**
+ * Sorts one segment with the kernel that suits its length
+ * @param first
+ * @param last
+ */
+static void SortSegment(size_t * first, size_t * last) {
+    int64_t N = last - first;
+    if (N < 2) return;
+    if (N > INSERTION_CUTOFF) {
+        int depth = 0;
+        for (int64_t n = N; n > 1; n >>= 1) depth++;
+        IntroSortLoop(first, last, 2*depth);
+    }
+    SmallInsertionSort(first, last);
+}
+
+/**
+ * Sorts segments [begin, end) of the offsets table one after another
+ * @param arr
+ * @param offsets
+ * @param begin
+ * @param end
+ */
+static void SortSegmentRange(size_t * arr, const std::vector <size_t> & offsets, size_t begin, size_t end) {
+    for (size_t s = begin; s < end; s++) {
+        SortSegment(arr + offsets[s], arr + offsets[s + 1]);
+    }
+}
+
+/**
+ * Sorts many small independent arrays stored back to back in one buffer.
+ * Segment s is arr[offsets[s], offsets[s+1]), so offsets holds one entry
+ * more than there are segments. Keys outside all segments are untouched.
+ * Segments are handed out to threads in contiguous groups of roughly equal
+ * key count, so per call setup is paid once for the whole batch.
+ * @param arr
+ * @param offsets - non decreasing, last entry at most arr.size()
+ * @param threads - 0 uses all hardware threads
+ */
+void SegmentedSort(std::vector <size_t> & arr, const std::vector <size_t> & offsets, unsigned threads) {
+    if (offsets.size() < 2) return;
+    for (size_t s = 1; s < offsets.size(); s++) {
+        if (offsets[s] < offsets[s - 1]) {
+            throw std::string("segment offsets must be non decreasing!");
+        }
+    }
+    if (offsets.back() > arr.size()) {
+        throw std::string("segment offsets run past the array!");
+    }
+
+    size_t segments = offsets.size() - 1;
+    size_t total = offsets.back() - offsets.front();
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min<size_t>(threads, segments);
+    if (threads <= 1 || total < PARALLEL_MIN_KEYS) {
+        SortSegmentRange(arr.data(), offsets, 0, segments);
+        return;
+    }
+
+    // cut the segment list wherever another 1/threads of the keys is reached.
+    // Reserved up front so only the thread constructor can throw
+    std::vector <std::thread> workers;
+    workers.reserve(threads);
+    try {
+        size_t begin = 0;
+        for (unsigned t = 1; t <= threads && begin < segments; t++) {
+            size_t target = offsets.front() + total / threads * t;
+            size_t end = begin + 1;
+            while (end < segments && (t == threads || offsets[end] < target)) {
+                end++;
+            }
+            workers.emplace_back(SortSegmentRange, arr.data(), std::cref(offsets), begin, end);
+            begin = end;
+        }
+    } catch (...) {
+        // a joinable thread must not be destroyed, wait for the ones started
+        for (auto & worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+    for (auto & worker : workers) {
+        worker.join();
+    }
+}
@@ -25,6 +25,7 @@
  */
 
 #include "SelectionSort.hpp"
+#include "SortInstrument.hpp"
 #include <algorithm>
 
 /**
@@ -39,11 +40,13 @@ void SelectionSort(std::vector<size_t>& arr) {
     int64_t min;
     for (int64_t i = 0; i < N-1; i++) {
         min = i;
+        MSORT_COMPARE(N - 1 - i);
         for (int64_t j = i+1; j < N; j++) {
             if (arr[j] < arr[min]) {
                 min = j;
             }
         }
+        MSORT_SWAP(1);
         std::swap(arr[min], arr[i]);
     }
 }
@@ -0,0 +1,114 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SortCatalog.hpp"
+#include "BubbleSort.hpp"
+#include "SelectionSort.hpp"
+#include "InsertionSort.hpp"
+#include "ShellSort.hpp"
+#include "QuickSort.hpp"
+#include "MergeSort.hpp"
+#include "BlockMergeSort.hpp"
+#include "HeapSort.hpp"
+#include "CountSort.hpp"
+#include "RadixSort.hpp"
+#include "SpreadSort.hpp"
+
+// The range based sorts take inclusive bounds and need high >= low
+
+static void RunQuickSort(std::vector <size_t> & arr) {
+    if (!arr.empty()) QuickSort(arr, 0, arr.size() - 1);
+}
+
+static void RunQuickSortIterative(std::vector <size_t> & arr) {
+    if (!arr.empty()) QuickSortIterative(arr, 0, arr.size() - 1);
+}
+
+static void RunDualPivotQuickSort(std::vector <size_t> & arr) {
+    if (!arr.empty()) DualPivotQuickSort(arr, 0, arr.size() - 1);
+}
+
+static void RunMergeSort(std::vector <size_t> & arr) {
+    if (!arr.empty()) MergeSort(arr, 0, arr.size() - 1);
+}
+
+static void RunMergeSortIterative(std::vector <size_t> & arr) {
+    if (!arr.empty()) MergeSortIterative(arr, 0, arr.size() - 1);
+}
+
+static void RunBinaryInsertionSort(std::vector <size_t> & arr) {
+    BinaryInsertionSort(arr);
+}
+
+static void RunShellSort(std::vector <size_t> & arr) {
+    ShellSort(arr);
+}
+
+static void RunRadixSort(std::vector <size_t> & arr) {
+    std::vector <RadixKeyField> fields(1, RadixKeyField(0, sizeof(size_t)));
+    RadixSortRecords(arr, fields);
+}
+
+static void RunSpreadSort(std::vector <size_t> & arr) {
+    SpreadSort(arr);
+}
+
+/**
+ * @return all algorithms, simple ones first
+ */
+const std::vector <SortAlgorithm> & SortAlgorithms() {
+    static const SortAlgorithm table[] = {
+        { "BubbleSort", BubbleSort, true, 0 },
+        { "SelectionSort", SelectionSort, true, 0 },
+        { "InsertionSort", InsertionSort, true, 0 },
+        { "BinaryInsertionSort", RunBinaryInsertionSort, true, 0 },
+        { "ShellSort", RunShellSort, false, 0 },
+        { "QuickSort", RunQuickSort, false, 0 },
+        { "QuickSortIterative", RunQuickSortIterative, false, 0 },
+        { "DualPivotQuickSort", RunDualPivotQuickSort, false, 0 },
+        { "MergeSort", RunMergeSort, false, 0 },
+        { "MergeSortIterative", RunMergeSortIterative, false, 0 },
+        { "BlockMergeSort", BlockMergeSort, false, 0 },
+        { "HeapSort", HeapSort, false, 0 },
+        { "CountSort", CountSort, false, 10000 },
+        { "RadixSort", RunRadixSort, false, 0 },
+        { "SpreadSort", RunSpreadSort, false, 0 },
+    };
+    static const std::vector <SortAlgorithm> algorithms(table, table + sizeof(table) / sizeof(table[0]));
+    return algorithms;
+}
+
+/**
+ * @param name - as listed in SortAlgorithms
+ * @return the algorithm or nullptr when there is none by that name
+ */
+const SortAlgorithm * FindSortAlgorithm(const std::string & name) {
+    const std::vector <SortAlgorithm> & algorithms = SortAlgorithms();
+    for (size_t i = 0; i < algorithms.size(); i++) {
+        if (name == algorithms[i].name) return &algorithms[i];
+    }
+    return nullptr;
+}
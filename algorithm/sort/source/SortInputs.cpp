@@ -0,0 +1,153 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SortInputs.hpp"
+#include "RandomFill.hpp"
+#include <algorithm>
+
+// Number of ascending runs in the sawtooth pattern
+static const size_t SAWTOOTH_TEETH = 32;
+// Number of distinct keys in the few unique pattern
+static const size_t FEW_UNIQUE_KEYS = 16;
+// Zipf ranks are drawn from at most this many distinct keys
+static const size_t ZIPF_MAX_KEYS = 1 << 20;
+// Center of the normal pattern, its standard deviation is N
+static const double NORMAL_MEAN = 1099511627776.0;
+
+static const char * const INPUT_NAMES[INPUT_COUNT] = {
+    "uniform", "sorted", "reverse", "organ-pipe", "sawtooth",
+    "few-unique", "zipf", "all-equal", "median3-killer", "normal"
+};
+
+/**
+ * @param input
+ * @return the name used on the command line and in reports
+ */
+const char * SortInputName(SortInput input) {
+    return input < INPUT_COUNT ? INPUT_NAMES[input] : "unknown";
+}
+
+/**
+ * Looks up a pattern by the name SortInputName returns
+ * @param name
+ * @param input - set when found
+ * @return false for unknown names
+ */
+bool ParseSortInput(const std::string & name, SortInput & input) {
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        if (name == INPUT_NAMES[i]) {
+            input = (SortInput) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Musser's median-of-3 killer. Taking the median of the first, middle
+ * and last key as pivot splits off only two keys per partition, so
+ * such a quick sort goes quadratic. The construction needs a multiple
+ * of four keys; the few left over are appended in order.
+ * @param N
+ * @param out
+ */
+static void GenerateMedian3Killer(size_t N, std::vector <size_t> & out) {
+    size_t M = N - N % 4;
+    size_t k = M / 2;
+    for (size_t i = 1; i <= k; i++) {
+        if (i % 2 == 1) {
+            out[i - 1] = i;
+            out[i] = k + i;
+        }
+        out[k + i - 1] = 2 * i;
+    }
+    for (size_t i = M; i < N; i++) {
+        out[i] = i + 1;
+    }
+}
+
+/**
+ * Fills out with N keys following the given pattern. Patterns with a
+ * random component are reproducible for a given seed, whatever the
+ * number of threads filling them.
+ * @param input
+ * @param N
+ * @param seed
+ * @param out - resized to N
+ */
+void GenerateSortInput(SortInput input, size_t N, uint64_t seed, std::vector <size_t> & out) {
+    out.resize(N);
+    size_t * keys = out.data();
+    switch (input) {
+    case INPUT_UNIFORM:
+        ParallelFill(keys, N, seed, UniformKeys());
+        break;
+    case INPUT_SORTED:
+        ParallelFill(keys, N, seed, [](Xoshiro256 &, size_t i) { return (uint64_t) i; });
+        break;
+    case INPUT_REVERSE:
+        ParallelFill(keys, N, seed, [N](Xoshiro256 &, size_t i) { return (uint64_t) (N - 1 - i); });
+        break;
+    case INPUT_ORGAN_PIPE:
+        ParallelFill(keys, N, seed, [N](Xoshiro256 &, size_t i) {
+            return (uint64_t) (i < N / 2 ? i : N - 1 - i);
+        });
+        break;
+    case INPUT_SAWTOOTH: {
+        size_t tooth = std::max(N / SAWTOOTH_TEETH, (size_t) 1);
+        ParallelFill(keys, N, seed, [tooth](Xoshiro256 &, size_t i) { return (uint64_t) (i % tooth); });
+        break;
+    }
+    case INPUT_FEW_UNIQUE: {
+        // the key set comes from a stream far away from the chunk streams
+        Xoshiro256 table(seed);
+        table.LongJump();
+        uint64_t unique[FEW_UNIQUE_KEYS];
+        for (size_t k = 0; k < FEW_UNIQUE_KEYS; k++) unique[k] = table();
+        const uint64_t * pick = unique;
+        ParallelFill(keys, N, seed, [pick](Xoshiro256 & gen, size_t) {
+            return pick[gen.Below(FEW_UNIQUE_KEYS)];
+        });
+        break;
+    }
+    case INPUT_ZIPF:
+        ParallelFill(keys, N, seed, ZipfKeys(std::min(std::max(N, (size_t) 1), ZIPF_MAX_KEYS), 1.0));
+        break;
+    case INPUT_ALL_EQUAL:
+        std::fill(out.begin(), out.end(), (size_t) 42);
+        break;
+    case INPUT_MEDIAN3_KILLER:
+        GenerateMedian3Killer(N, out);
+        break;
+    case INPUT_NORMAL:
+        ParallelFill(keys, N, seed, NormalKeys(NORMAL_MEAN, std::max(N, (size_t) 16)));
+        break;
+    default: {
+        std::string s("unknown sort input pattern");
+        throw s;
+    }
+    }
+}
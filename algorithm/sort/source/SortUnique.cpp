@@ -0,0 +1,204 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SortUnique.hpp"
+#include "SpreadSort.hpp"
+#include <algorithm>
+
+// Counting is used while the key range is at most this many times the key count
+static const size_t COUNT_RANGE_FACTOR = 2;
+// and never with more counters than this
+static const size_t COUNT_RANGE_MAX = 1 << 24;
+// Keys per top level bucket, small enough to stay in L2 while the
+// bucket is sorted and then compacted
+static const size_t BUCKET_KEYS = 1 << 14;
+
+/**
+ * Finds the smallest and largest key
+ * @param arr - not empty
+ * @param min
+ * @param max
+ */
+static void MinMax(const std::vector <size_t> & arr, size_t & min, size_t & max) {
+    min = max = arr[0];
+    for (size_t i = 1; i < arr.size(); i++) {
+        if (arr[i] < min) min = arr[i];
+        if (arr[i] > max) max = arr[i];
+    }
+}
+
+/**
+ * Checks whether a counting array over [min, max] is cheaper than sorting
+ * @param N - number of keys
+ * @param min
+ * @param max
+ * @return true if counting should be used
+ */
+static bool UseCounting(size_t N, size_t min, size_t max) {
+    return max - min < COUNT_RANGE_MAX && max - min < COUNT_RANGE_FACTOR * N;
+}
+
+/**
+ * Sorts arr bucket by bucket and hands every sorted bucket to emit while
+ * it is still in cache. Keys are first scattered by their top bits, so
+ * the buckets come out in ascending order and only that one scatter
+ * pass touches the whole array.
+ * @param arr
+ * @param min
+ * @param max
+ * @param emit - called as emit(first, last) once per bucket, in key order
+ */
+template <typename Emit>
+static void SortBuckets(const std::vector <size_t> & arr, size_t min, size_t max, Emit emit) {
+    size_t N = arr.size();
+    size_t target = N / BUCKET_KEYS + 1;
+    unsigned shift = 0;
+    while (((max - min) >> shift) >= target) shift++;
+    size_t buckets = ((max - min) >> shift) + 1;
+
+    std::vector <size_t> sizes(buckets), offsets(buckets);
+    for (size_t i = 0; i < N; i++) {
+        sizes[(arr[i] - min) >> shift]++;
+    }
+    size_t sum = 0, largest = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        offsets[b] = sum;
+        sum += sizes[b];
+        largest = std::max(largest, sizes[b]);
+    }
+    std::vector <size_t> keys(N), scratch(largest);
+    for (size_t i = 0; i < N; i++) {
+        keys[offsets[(arr[i] - min) >> shift]++] = arr[i];
+    }
+
+    size_t * bucket = keys.data();
+    for (size_t b = 0; b < buckets; b++) {
+        if (sizes[b]) {
+            SpreadSort(bucket, bucket + sizes[b], scratch.data());
+            emit(bucket, bucket + sizes[b]);
+        }
+        bucket += sizes[b];
+    }
+}
+
+/**
+ * Appends the distinct keys of each sorted bucket to arr
+ */
+struct EmitUnique {
+    std::vector <size_t> * out;
+    size_t last;
+    void operator()(const size_t * first, const size_t * end) {
+        std::vector <size_t> & arr = *out;
+        for (; first < end; first++) {
+            if (arr.empty() || *first != last) {
+                arr.push_back(*first);
+                last = *first;
+            }
+        }
+    }
+};
+
+/**
+ * Appends a (key, count) pair per distinct key of each sorted bucket
+ */
+struct EmitCount {
+    std::vector <std::pair <size_t, size_t> > * out;
+    void operator()(const size_t * first, const size_t * end) {
+        std::vector <std::pair <size_t, size_t> > & counts = *out;
+        while (first < end) {
+            const size_t * run = first + 1;
+            while (run < end && *run == *first) run++;
+            if (!counts.empty() && counts.back().first == *first) {
+                counts.back().second += run - first;
+            } else {
+                counts.push_back(std::make_pair(*first, (size_t) (run - first)));
+            }
+            first = run;
+        }
+    }
+};
+
+/**
+ * Sorts arr and drops repeated keys. Small key ranges are counted and
+ * the distinct keys written straight back. Otherwise keys are scattered
+ * into cache sized buckets which are sorted and compacted one at a time,
+ * so the sorted array with duplicates is never written out and rescanned.
+ * @param arr
+ */
+void SortUnique(std::vector <size_t> & arr) {
+    if (arr.size() < 2) return;
+
+    size_t min, max;
+    MinMax(arr, min, max);
+    if (UseCounting(arr.size(), min, max)) {
+        size_t range = max - min + 1;
+        std::vector <unsigned char> seen(range);
+        for (size_t i = 0; i < arr.size(); i++) {
+            seen[arr[i] - min] = 1;
+        }
+        size_t k = 0;
+        for (size_t v = 0; v < range; v++) {
+            arr[k] = min + v;
+            k += seen[v];
+        }
+        arr.resize(k);
+        return;
+    }
+
+    std::vector <size_t> unique;
+    EmitUnique emit = { &unique, 0 };
+    SortBuckets(arr, min, max, emit);
+    arr.swap(unique);
+}
+
+/**
+ * Fills counts with the distinct keys of arr in ascending order, each
+ * with its number of occurrences. With a small key range these are read
+ * off the CountSort style counting array; otherwise they are emitted
+ * straight from each sorted bucket.
+ * @param arr
+ * @param counts - replaced with the result
+ */
+void SortCount(const std::vector <size_t> & arr, std::vector <std::pair <size_t, size_t> > & counts) {
+    counts.clear();
+    if (arr.empty()) return;
+
+    size_t min, max;
+    MinMax(arr, min, max);
+    if (UseCounting(arr.size(), min, max)) {
+        std::vector <size_t> count(max - min + 1);
+        for (size_t i = 0; i < arr.size(); i++) {
+            count[arr[i] - min]++;
+        }
+        for (size_t v = 0; v < count.size(); v++) {
+            if (count[v]) counts.push_back(std::make_pair(min + v, count[v]));
+        }
+        return;
+    }
+
+    EmitCount emit = { &counts };
+    SortBuckets(arr, min, max, emit);
+}
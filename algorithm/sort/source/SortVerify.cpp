@@ -0,0 +1,154 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SortVerify.hpp"
+#include <thread>
+#include <algorithm>
+#include <functional>
+
+// Below this many keys per thread, starting threads costs more than it saves
+static const size_t MIN_KEYS_PER_THREAD = 1 << 18;
+
+/**
+ * Murmur3's 64 bit finaliser, every input bit flips about half the
+ * output bits
+ * @param x
+ * @return mixed
+ */
+static inline uint64_t Mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * Partial result of one chunk
+ */
+struct ChunkCheck {
+    bool sorted;
+    size_t firstUnsorted;
+    MultisetHash hash;
+};
+
+/**
+ * Hashes keys[begin, end) and, if ORDER is set, finds the first key
+ * below its predecessor, looking back across the chunk start. Both are
+ * done in one pass so every key is read from memory once.
+ * @param keys
+ * @param begin
+ * @param end
+ * @param out
+ */
+template <bool ORDER>
+static void CheckChunk(const size_t * keys, size_t begin, size_t end, ChunkCheck & out) {
+    // seeds of the two mixes, any distinct odd constants do
+    const uint64_t SEED_LOW = 0x9E3779B97F4A7C15ull, SEED_HIGH = 0xD1B54A32D192ED03ull;
+    uint64_t low = 0, high = 0;
+    size_t previous = begin ? keys[begin - 1] : 0;
+    // no early exit keeps the loop branch free, the exact index is only searched on failure
+    bool sorted = true;
+    for (size_t i = begin; i < end; i++) {
+        size_t key = keys[i];
+        low += Mix(key ^ SEED_LOW);
+        high += Mix(key * SEED_HIGH + 1);
+        if (ORDER) sorted &= previous <= key;
+        previous = key;
+    }
+    out.hash.low = low;
+    out.hash.high = high;
+    out.hash.count = end - begin;
+    out.sorted = sorted;
+    out.firstUnsorted = end;
+    if (!sorted) {
+        size_t i = begin ? begin : 1;
+        while (keys[i - 1] <= keys[i]) i++;
+        out.firstUnsorted = i;
+    }
+}
+
+/**
+ * Runs CheckChunk on one chunk per thread and combines the results
+ * @param keys
+ * @param N
+ * @param threads
+ * @param order
+ * @return check
+ */
+static SortCheck CheckParallel(const size_t * keys, size_t N, unsigned threads, bool order) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min(threads, (unsigned) (N / MIN_KEYS_PER_THREAD)));
+    std::vector <ChunkCheck> chunks(threads);
+    void (*checkChunk)(const size_t *, size_t, size_t, ChunkCheck &) =
+            order ? CheckChunk<true> : CheckChunk<false>;
+    if (threads == 1) {
+        checkChunk(keys, 0, N, chunks[0]);
+    } else {
+        // reserved up front so only the thread constructor can throw
+        std::vector <std::thread> workers;
+        workers.reserve(threads);
+        try {
+            for (unsigned t = 0; t < threads; t++) {
+                workers.emplace_back(checkChunk, keys, N * t / threads, N * (t + 1) / threads,
+                        std::ref(chunks[t]));
+            }
+        } catch (...) {
+            // a joinable thread must not be destroyed, wait for the ones started
+            for (auto & worker : workers) {
+                worker.join();
+            }
+            throw;
+        }
+        for (auto & worker : workers) {
+            worker.join();
+        }
+    }
+    SortCheck check = SortCheck();
+    check.firstUnsorted = N;
+    for (unsigned t = 0; t < threads; t++) {
+        check.hash.low += chunks[t].hash.low;
+        check.hash.high += chunks[t].hash.high;
+        check.hash.count += chunks[t].hash.count;
+        if (!chunks[t].sorted) check.firstUnsorted = std::min(check.firstUnsorted, chunks[t].firstUnsorted);
+    }
+    check.sorted = check.firstUnsorted == N;
+    return check;
+}
+
+MultisetHash HashKeys(const size_t * keys, size_t N, unsigned threads) {
+    return CheckParallel(keys, N, threads, false).hash;
+}
+
+SortCheck VerifySorted(const size_t * keys, size_t N, unsigned threads) {
+    return CheckParallel(keys, N, threads, true);
+}
+
+bool VerifySort(const std::vector <size_t> & output, const MultisetHash & input) {
+    SortCheck check = VerifySorted(output.data(), output.size());
+    return check.sorted && check.hash == input;
+}
@@ -0,0 +1,187 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SpreadSort.hpp"
+#include "SortInstrument.hpp"
+#include <algorithm>
+#include <cstring>
+
+// Ranges up to this size are finished by insertion sort
+static const size_t SPREAD_INSERTION_CUTOFF = 32;
+// Average number of keys per bucket a spreading pass aims for
+static const size_t KEYS_PER_BUCKET = 4;
+// Bucket counts stay small enough for the counters to live in L2
+static const size_t MAX_BUCKETS = 1 << 16;
+// A bucket holding more than 1/SKEW_DIVISOR of the keys was not split
+// usefully; comparison sort it instead of spreading again
+static const size_t SKEW_DIVISOR = 16;
+// Spreading passes allowed before giving up on the distribution
+static const int MAX_SPREAD_DEPTH = 4;
+
+/**
+ * Plain insertion sort on [first, last)
+ * @param first
+ * @param last
+ */
+template <typename Key>
+static void InsertionSortKeys(Key * first, Key * last) {
+    for (Key * i = first + 1; i < last; i++) {
+        Key temp = *i;
+        Key * j = i;
+        while (j > first && (MSORT_COMPARE(1), *(j - 1) > temp)) {
+            MSORT_MOVE(1);
+            *j = *(j - 1);
+            j--;
+        }
+        MSORT_MOVE(j != i);
+        *j = temp;
+    }
+}
+
+/**
+ * Spreads [first, last) into buckets of width 2^shift starting at the
+ * minimum key, then sorts every bucket on its own
+ * @param first
+ * @param last
+ * @param scratch - room for last - first keys
+ * @param depth - spreading passes left
+ */
+template <typename Key>
+static void SpreadSortRange(Key * first, Key * last, Key * scratch, int depth) {
+    MSORT_DEPTH();
+    size_t N = last - first;
+    if (N <= SPREAD_INSERTION_CUTOFF) {
+        InsertionSortKeys(first, last);
+        return;
+    }
+    if (depth == 0) {
+        std::sort(first, last, CountingLess());
+        return;
+    }
+
+    Key min = *first, max = *first;
+    for (Key * it = first + 1; it < last; it++) {
+        if (*it < min) min = *it;
+        if (*it > max) max = *it;
+    }
+    if (min == max) return;
+
+    // Linear interpolation rounded to a power of two: bucket = (key - min) >> shift
+    Key range = max - min;
+    size_t target = std::min(N / KEYS_PER_BUCKET, MAX_BUCKETS);
+    unsigned shift = 0;
+    while ((range >> shift) >= target) shift++;
+    size_t buckets = (size_t)(range >> shift) + 1;
+
+    std::vector <size_t> sizes(buckets), offsets(buckets);
+    MSORT_AUX(2 * buckets * sizeof(size_t));
+    for (Key * it = first; it < last; it++) {
+        sizes[(size_t)((*it - min) >> shift)]++;
+    }
+    size_t sum = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        offsets[b] = sum;
+        sum += sizes[b];
+    }
+    for (Key * it = first; it < last; it++) {
+        scratch[offsets[(size_t)((*it - min) >> shift)]++] = *it;
+    }
+    std::memcpy(first, scratch, N * sizeof(Key));
+    MSORT_MOVE(2 * N);
+
+    Key * bucket = first;
+    for (size_t b = 0; b < buckets; b++) {
+        size_t size = sizes[b];
+        if (size > N / SKEW_DIVISOR && size > SPREAD_INSERTION_CUTOFF) {
+            std::sort(bucket, bucket + size, CountingLess());
+        } else {
+            SpreadSortRange(bucket, bucket + size, scratch, depth - 1);
+        }
+        bucket += size;
+    }
+}
+
+/**
+ * Maps a double to an unsigned key with the same order: negatives get
+ * all bits flipped, positives just the sign bit
+ * @param d
+ * @return key
+ */
+static uint64_t DoubleToKey(double d) {
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+/**
+ * Inverse of DoubleToKey
+ * @param key
+ * @return double
+ */
+static double KeyToDouble(uint64_t key) {
+    uint64_t bits = (key >> 63) ? key & ~(uint64_t(1) << 63) : ~key;
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+/**
+ * This method takes O(n) auxillary space
+ * @param arr
+ */
+void SpreadSort(std::vector <size_t> & arr) {
+    if (arr.size() < 2) return;
+    std::vector <size_t> scratch(arr.size());
+    MSORT_AUX(scratch.size() * sizeof(size_t));
+    SpreadSortRange(&arr[0], &arr[0] + arr.size(), &scratch[0], MAX_SPREAD_DEPTH);
+}
+
+/**
+ * Sorts [first, last) using the caller's scratch space
+ * @param first
+ * @param last
+ * @param scratch
+ */
+void SpreadSort(size_t * first, size_t * last, size_t * scratch) {
+    SpreadSortRange(first, last, scratch, MAX_SPREAD_DEPTH);
+}
+
+/**
+ * This method takes O(n) auxillary space
+ * @param arr
+ */
+void SpreadSort(std::vector <double> & arr) {
+    if (arr.size() < 2) return;
+    std::vector <uint64_t> keys(arr.size()), scratch(arr.size());
+    MSORT_AUX(2 * arr.size() * sizeof(uint64_t));
+    for (size_t i = 0; i < arr.size(); i++) {
+        keys[i] = DoubleToKey(arr[i]);
+    }
+    SpreadSortRange(&keys[0], &keys[0] + keys.size(), &scratch[0], MAX_SPREAD_DEPTH);
+    for (size_t i = 0; i < arr.size(); i++) {
+        arr[i] = KeyToDouble(keys[i]);
+    }
+}
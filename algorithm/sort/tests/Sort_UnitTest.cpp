@@ -32,8 +32,40 @@
 #include "PrintUtil.hpp"
 #include "HeapSort.hpp"
 #include "PrintUtil.hpp"
+#include "BlockMergeSort.hpp"
+#include "MergeKernel.hpp"
+#include "SegmentedSort.hpp"
+#include "IncrementalSort.hpp"
+#include "ShellSort.hpp"
+#include "RadixSort.hpp"
+#include "SpreadSort.hpp"
+#include "SortUnique.hpp"
+#include "SortCatalog.hpp"
+#include "SortInputs.hpp"
+#include "SortInstrument.hpp"
+#include "PerfCounters.hpp"
+#include "LatencyHistogram.hpp"
+#include "FastWriter.hpp"
+#include "FastReader.hpp"
+#include "MappedSort.hpp"
+#include "RandomFill.hpp"
+#include "SortVerify.hpp"
 #include <vector>
 #include <stdexcept>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <thread>
+#include <sstream>
+#include <cstdio>
+#include <unistd.h>
 #include <gtest/gtest.h>
 
 /**
@@ -1902,6 +1934,1227 @@ TEST(HeapSort, Correctness_1000)
   ASSERT_EQ(1, arr == res);
 }
 
+/**
+ *
+ * BlockMergeSortTest
+ * 
+ */
+TEST(BlockMergeSortTest, NULLTest)
+{
+  std::vector < size_t > arr;
+  EXPECT_NO_THROW(BlockMergeSort (arr));
+}
+
+// For 100 numbers
+TEST(BlockMergeSortTest, Correctness)
+{
+  std::vector < size_t > arr { 38, 98, 79, 69, 14, 76, 59, 2, 47, 3, 26, 99, 12,
+      52, 51, 22, 15, 1, 39, 18, 46, 44, 16, 50, 36, 72, 9, 100, 23, 37, 20, 89,
+      92, 5, 53, 74, 75, 56, 30, 88, 49, 87, 78, 94, 57, 48, 85, 31, 60, 90, 62,
+      27, 6, 61, 43, 21, 73, 7, 81, 63, 58, 24, 83, 86, 67, 25, 54, 68, 97, 28,
+      13, 95, 29, 40, 91, 65, 70, 66, 33, 55, 77, 41, 8, 71, 17, 64, 96, 45, 34,
+      84, 32, 19, 11, 10, 42, 35, 4, 80, 82, 93 };
+  BlockMergeSort (arr);
+  std::vector < size_t > res { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+      15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+      33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50,
+      51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68,
+      69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86,
+      87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100 };
+  ASSERT_EQ(1, arr == res);
+}
+
+// Random input with and without a (small) scratch buffer
+TEST(BlockMergeSortTest, Correctness_Random)
+{
+  std::mt19937_64 gen (26);
+  std::vector < size_t > arr (100000);
+  for (auto &el : arr)
+    el = gen () % 5000;
+  std::vector < size_t > res (arr);
+  std::sort (res.begin (), res.end ());
+
+  std::vector < size_t > arr_cpy (arr);
+  BlockMergeSort (arr);
+  ASSERT_EQ(1, arr == res);
+
+  std::vector < size_t > buffer (64);
+  BlockMergeSort (arr_cpy, buffer);
+  ASSERT_EQ(1, arr_cpy == res);
+}
+
+// Too few distinct keys for the internal buffer, and buffers of any size
+TEST(BlockMergeSortTest, Correctness_Keys)
+{
+  std::mt19937_64 gen (126);
+  for (size_t distinct : { 1, 7, 300, 1 << 30 })
+  {
+    std::vector < size_t > arr (20011);
+    for (auto &el : arr)
+      el = gen () % distinct;
+    std::vector < size_t > res (arr);
+    std::sort (res.begin (), res.end ());
+    for (size_t bufSize : { 0, 5, 100, 10006 })
+    {
+      std::vector < size_t > arr_cpy (arr);
+      std::vector < size_t > buffer (bufSize);
+      BlockMergeSort (arr_cpy, buffer);
+      ASSERT_EQ(1, arr_cpy == res);
+    }
+  }
+}
+
+/**
+ *
+ * MergeKernelTest
+ * 
+ */
+TEST(MergeKernelTest, InPlaceRightRun)
+{
+  // left run copied out, right run merged from where it sits
+  std::vector < size_t > left { 1, 4, 4, 9 };
+  std::vector < size_t > arr { 0, 0, 0, 0, 2, 3, 4, 10, 11 };
+  size_t *end = MergeBranchless (left.data (), left.size (), arr.data () + 4, 5,
+                                 arr.data ());
+  std::vector < size_t > res { 1, 2, 3, 4, 4, 4, 9, 10, 11 };
+  ASSERT_EQ(1, arr == res);
+  ASSERT_EQ(1, end == arr.data () + arr.size ());
+}
+
+// Sub range sorts must leave everything outside [low, high] alone
+TEST(MergeSortTest, SubRange)
+{
+  std::mt19937_64 gen (27);
+  std::vector < size_t > arr (1001);
+  for (auto &el : arr)
+    el = gen () % 100;
+  std::vector < size_t > res (arr);
+  std::sort (res.begin () + 17, res.begin () + 901);
+
+  std::vector < size_t > arr_cpy (arr);
+  MergeSort (arr, 17, 900);
+  ASSERT_EQ(1, arr == res);
+  MergeSortIterative (arr_cpy, 17, 900);
+  ASSERT_EQ(1, arr_cpy == res);
+}
+
+
+// Every kernel, separate output and in place output, all tail shapes
+TEST(MergeKernelTest, BitonicAllIsa)
+{
+  std::mt19937_64 gen (28);
+  MergeIsa isas[] = { MERGE_ISA_SCALAR, MERGE_ISA_AVX2, MERGE_ISA_AVX512 };
+  for (MergeIsa isa : isas)
+  {
+    for (size_t N1 = 0; N1 < 40; N1++)
+    {
+      for (size_t N2 = 0; N2 < 40; N2++)
+      {
+        std::vector < size_t > arr (N1 + N2);
+        for (auto &el : arr)
+          el = (N1 & 1) ? gen () % 16 : gen ();
+        std::sort (arr.begin (), arr.begin () + N1);
+        std::sort (arr.begin () + N1, arr.end ());
+        std::vector < size_t > res (arr);
+        std::sort (res.begin (), res.end ());
+
+        std::vector < size_t > left (arr.begin (), arr.begin () + N1);
+        std::vector < size_t > out (N1 + N2);
+        MergeBitonic (left.data (), N1, arr.data () + N1, N2, out.data (), isa);
+        ASSERT_EQ(1, out == res);
+
+        size_t *end = MergeBitonic (left.data (), N1, arr.data () + N1, N2,
+                                    arr.data (), isa);
+        ASSERT_EQ(1, arr == res);
+        ASSERT_EQ(1, end == arr.data () + arr.size ());
+      }
+    }
+  }
+}
+
+/**
+ *
+ * SegmentedSortTest
+ * 
+ */
+TEST(SegmentedSortTest, NULLTest)
+{
+  std::vector < size_t > arr;
+  std::vector < size_t > offsets { 0 };
+  EXPECT_NO_THROW(SegmentedSort (arr, offsets));
+  offsets.push_back (0);
+  EXPECT_NO_THROW(SegmentedSort (arr, offsets));
+}
+
+TEST(SegmentedSortTest, BadOffsets)
+{
+  std::vector < size_t > arr (10);
+  std::vector < size_t > offsets { 0, 5, 3, 10 };
+  EXPECT_ANY_THROW(SegmentedSort (arr, offsets));
+  offsets = { 0, 5, 11 };
+  EXPECT_ANY_THROW(SegmentedSort (arr, offsets));
+}
+
+// Segment lengths 0 to 600, sorted with one and with four threads
+TEST(SegmentedSortTest, Correctness)
+{
+  std::mt19937_64 gen (29);
+  std::vector < size_t > offsets { 0 };
+  while (offsets.back () < 200000)
+    offsets.push_back (offsets.back () + gen () % 600);
+  std::vector < size_t > arr (offsets.back () + 7);
+  for (auto &el : arr)
+    el = gen () % 1000;
+  std::vector < size_t > res (arr);
+  for (size_t s = 0; s + 1 < offsets.size (); s++)
+    std::sort (res.begin () + offsets[s], res.begin () + offsets[s + 1]);
+
+  std::vector < size_t > arr_cpy (arr);
+  SegmentedSort (arr, offsets, 1);
+  ASSERT_EQ(1, arr == res);
+  SegmentedSort (arr_cpy, offsets, 4);
+  ASSERT_EQ(1, arr_cpy == res);
+}
+
+/**
+ *
+ * IncrementalSortTest
+ * 
+ */
+TEST(IncrementalSortTest, NULLTest)
+{
+  std::vector < size_t > arr, batch;
+  EXPECT_NO_THROW(MergeInsertBatch (arr, batch));
+  EXPECT_NO_THROW(RepairSorted (arr, batch));
+  batch = { 3, 1, 2 };
+  MergeInsertBatch (arr, batch);
+  std::vector < size_t > res { 1, 2, 3 };
+  ASSERT_EQ(1, arr == res);
+}
+
+// Batches far smaller than the array (galloping) and comparable to it
+TEST(IncrementalSortTest, MergeInsertBatch)
+{
+  std::mt19937_64 gen (30);
+  size_t sizes[] = { 1, 5, 100, 5000, 30000 };
+  for (size_t k : sizes)
+  {
+    std::vector < size_t > arr (20000);
+    for (auto &el : arr)
+      el = gen () % 50000;
+    std::sort (arr.begin (), arr.end ());
+    std::vector < size_t > batch (k);
+    for (auto &el : batch)
+      el = gen () % 60000;
+    std::vector < size_t > res (arr);
+    res.insert (res.end (), batch.begin (), batch.end ());
+    std::sort (res.begin (), res.end ());
+
+    MergeInsertBatch (arr, batch);
+    ASSERT_EQ(1, arr == res);
+  }
+}
+
+// A few and many overwritten slots, including the first and the last one
+TEST(IncrementalSortTest, RepairSorted)
+{
+  std::mt19937_64 gen (30);
+  size_t counts[] = { 1, 3, 64, 65, 2000 };
+  for (size_t k : counts)
+  {
+    std::vector < size_t > arr (10000);
+    for (auto &el : arr)
+      el = gen () % 20000;
+    std::sort (arr.begin (), arr.end ());
+    std::vector < size_t > dirty { 0, arr.size () - 1 };
+    for (size_t i = 0; i < k; i++)
+      dirty.push_back (gen () % arr.size ());
+    for (auto pos : dirty)
+      arr[pos] = gen () % 25000;
+    std::vector < size_t > res (arr);
+    std::sort (res.begin (), res.end ());
+
+    RepairSorted (arr, dirty);
+    ASSERT_EQ(1, arr == res);
+  }
+  std::vector < size_t > arr (10);
+  EXPECT_ANY_THROW(RepairSorted (arr, { 10 }));
+}
+
+/**
+ *
+ * DualPivotQuickSortTest
+ * 
+ */
+TEST(DualPivotQuickSortTest, NULLTest)
+{
+  std::vector < size_t > arr;
+  EXPECT_NO_THROW(DualPivotQuickSort (arr, 0, arr.size () - 1));
+}
+
+// For 100 numbers
+TEST(DualPivotQuickSortTest, Correctness)
+{
+  std::vector < size_t > arr { 38, 98, 79, 69, 14, 76, 59, 2, 47, 3, 26, 99, 12,
+      52, 51, 22, 15, 1, 39, 18, 46, 44, 16, 50, 36, 72, 9, 100, 23, 37, 20, 89,
+      92, 5, 53, 74, 75, 56, 30, 88, 49, 87, 78, 94, 57, 48, 85, 31, 60, 90, 62,
+      27, 6, 61, 43, 21, 73, 7, 81, 63, 58, 24, 83, 86, 67, 25, 54, 68, 97, 28,
+      13, 95, 29, 40, 91, 65, 70, 66, 33, 55, 77, 41, 8, 71, 17, 64, 96, 45, 34,
+      84, 32, 19, 11, 10, 42, 35, 4, 80, 82, 93 };
+  DualPivotQuickSort (arr, 0, arr.size () - 1);
+  std::vector < size_t > res { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+      15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+      33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50,
+      51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68,
+      69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86,
+      87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100 };
+  ASSERT_EQ(1, arr == res);
+}
+
+// Random, few unique, sorted, reverse and all equal keys
+TEST(DualPivotQuickSortTest, Correctness_Patterns)
+{
+  std::mt19937_64 gen (31);
+  for (int pattern = 0; pattern < 5; pattern++)
+  {
+    std::vector < size_t > arr (100000);
+    for (size_t i = 0; i < arr.size (); i++)
+    {
+      size_t vals[] = { gen (), gen () % 4, i, arr.size () - i, 7 };
+      arr[i] = vals[pattern];
+    }
+    std::vector < size_t > res (arr);
+    std::sort (res.begin (), res.end ());
+    DualPivotQuickSort (arr, 0, arr.size () - 1);
+    ASSERT_EQ(1, arr == res);
+  }
+}
+
+/*
+ * McIlroy's adversary played against the pivot sampling and partition
+ * of DualPivotQuickSort. Keys stay gas until a comparison forces one to
+ * freeze, and frozen keys are smaller than any gas, so the pivots always
+ * come out near the bottom of the range.
+ */
+struct DualPivotAdversary
+{
+  std::vector < size_t > val;
+  std::vector < size_t > pos;
+  size_t gas, solid, candidate;
+
+  DualPivotAdversary (size_t n) :
+      val (n, n), pos (n), gas (n), solid (0), candidate (n)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      pos[i] = i;
+    }
+  }
+
+  bool Less (size_t x, size_t y)
+  {
+    if (val[x] == gas && val[y] == gas)
+    {
+      val[x == candidate ? x : y] = solid++;
+    }
+    if (val[x] == gas)
+    {
+      candidate = x;
+    }
+    else if (val[y] == gas)
+    {
+      candidate = y;
+    }
+    return val[x] < val[y];
+  }
+
+  bool LessAt (int64_t i, int64_t j)
+  {
+    return Less (pos[i], pos[j]);
+  }
+
+  void Partition (int64_t lo, int64_t hi, int64_t & lp, int64_t & rp)
+  {
+    int64_t step = (hi - lo) / 6;
+    int64_t s[5] = { lo + step, lo + 2 * step, lo + 3 * step, lo + 4 * step, lo + 5 * step };
+    for (int i = 1; i < 5; i++)
+    {
+      for (int j = i; j > 0 && LessAt (s[j], s[j - 1]); j--)
+      {
+        std::swap (pos[s[j]], pos[s[j - 1]]);
+      }
+    }
+    std::swap (pos[lo], pos[s[1]]);
+    std::swap (pos[hi], pos[s[3]]);
+
+    if (LessAt (hi, lo))
+    {
+      std::swap (pos[lo], pos[hi]);
+    }
+    int64_t l = lo + 1, k = lo + 1, g = hi - 1;
+    while (k <= g)
+    {
+      if (LessAt (k, lo))
+      {
+        std::swap (pos[k++], pos[l++]);
+        continue;
+      }
+      if (LessAt (hi, k))
+      {
+        while (LessAt (hi, g) && k < g)
+        {
+          g--;
+        }
+        std::swap (pos[k], pos[g--]);
+        if (LessAt (k, lo))
+        {
+          std::swap (pos[k], pos[l++]);
+        }
+      }
+      k++;
+    }
+    lp = l - 1;
+    rp = g + 1;
+    std::swap (pos[lo], pos[lp]);
+    std::swap (pos[hi], pos[rp]);
+  }
+
+  void Sort (int64_t lo, int64_t hi)
+  {
+    while (hi - lo >= 17)
+    {
+      int64_t lp, rp;
+      Partition (lo, hi, lp, rp);
+      int64_t start[3] = { lo, lp + 1, rp + 1 };
+      int64_t end[3] = { lp - 1, rp - 1, hi };
+      int biggest = 0;
+      for (int i = 1; i < 3; i++)
+      {
+        if (end[i] - start[i] > end[biggest] - start[biggest])
+        {
+          biggest = i;
+        }
+      }
+      for (int i = 0; i < 3; i++)
+      {
+        if (i != biggest)
+        {
+          Sort (start[i], end[i]);
+        }
+      }
+      lo = start[biggest];
+      hi = end[biggest];
+    }
+    for (int64_t i = lo + 1; i <= hi; i++)
+    {
+      for (int64_t j = i; j > lo && LessAt (j, j - 1); j--)
+      {
+        std::swap (pos[j], pos[j - 1]);
+      }
+    }
+  }
+
+  /* freezes what is still gas once the sort is over */
+  void Run ()
+  {
+    Sort (0, pos.size () - 1);
+    for (size_t i = 0; i < val.size (); i++)
+    {
+      if (val[i] == gas)
+      {
+        val[i] = solid++;
+      }
+    }
+  }
+};
+
+// Input built to split badly at every level, heap sort has to take over
+TEST(DualPivotQuickSortTest, Adversary)
+{
+  DualPivotAdversary adversary (10000);
+  adversary.Run ();
+  std::vector < size_t > arr (adversary.val);
+  ResetSortCounters ();
+  DualPivotQuickSort (arr, 0, arr.size () - 1);
+  SortCounters counters = ThreadSortCounters ();
+  for (size_t i = 0; i < arr.size (); i++)
+  {
+    ASSERT_EQ(i, arr[i]);
+  }
+  if (SortInstrumentEnabled ())
+  {
+    /* a few n log2 n, the unguarded loop needs about n^2 / 8 */
+    ASSERT_EQ(1, counters.comparisons < 10 * 10000 * 14);
+  }
+}
+
+/**
+ *
+ * BinaryInsertionSortTest
+ * 
+ */
+TEST(BinaryInsertionSortTest, NULLTest)
+{
+  std::vector < size_t > arr;
+  EXPECT_NO_THROW(BinaryInsertionSort (arr));
+}
+
+// For 100 numbers
+TEST(BinaryInsertionSortTest, Correctness)
+{
+  std::vector < size_t > arr { 38, 98, 79, 69, 14, 76, 59, 2, 47, 3, 26, 99, 12,
+      52, 51, 22, 15, 1, 39, 18, 46, 44, 16, 50, 36, 72, 9, 100, 23, 37, 20, 89,
+      92, 5, 53, 74, 75, 56, 30, 88, 49, 87, 78, 94, 57, 48, 85, 31, 60, 90, 62,
+      27, 6, 61, 43, 21, 73, 7, 81, 63, 58, 24, 83, 86, 67, 25, 54, 68, 97, 28,
+      13, 95, 29, 40, 91, 65, 70, 66, 33, 55, 77, 41, 8, 71, 17, 64, 96, 45, 34,
+      84, 32, 19, 11, 10, 42, 35, 4, 80, 82, 93 };
+  BinaryInsertionSort (arr);
+  std::vector < size_t > res { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+      15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+      33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50,
+      51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68,
+      69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86,
+      87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100 };
+  ASSERT_EQ(1, arr == res);
+}
+
+// Non trivially copyable elements, stability on equal keys
+TEST(BinaryInsertionSortTest, Strings)
+{
+  std::vector < std::pair<int, std::string> > arr { { 3, "a" }, { 1, "b" }, {
+      3, "c" }, { 2, "d" }, { 1, "e" } };
+  struct KeyOnly
+  {
+    std::pair<int, std::string> p;
+    bool operator< (const KeyOnly &o) const { return p.first < o.p.first; }
+  };
+  std::vector < KeyOnly > keyed;
+  for (auto &el : arr)
+    keyed.push_back ( { el });
+  BinaryInsertionSort (keyed);
+  std::string order;
+  for (auto &el : keyed)
+    order += el.p.second;
+  ASSERT_EQ("bedac", order);
+}
+
+/**
+ *
+ * ShellSortTest
+ * 
+ */
+TEST(ShellSortTest, NULLTest)
+{
+  std::vector < size_t > arr;
+  EXPECT_NO_THROW(ShellSort (arr));
+}
+
+// Both gap sequences on integers, doubles and strings
+TEST(ShellSortTest, Correctness)
+{
+  std::mt19937_64 gen (32);
+  ShellGaps gaps[] = { SHELL_GAPS_CIURA, SHELL_GAPS_TOKUDA };
+  for (ShellGaps g : gaps)
+  {
+    std::vector < size_t > arr (5000);
+    std::vector < double > darr (5000);
+    std::vector < std::string > sarr (500);
+    for (auto &el : arr)
+      el = gen () % 1000;
+    for (auto &el : darr)
+      el = (double) gen () / 3.0;
+    for (auto &el : sarr)
+      el = std::to_string (gen () % 100000);
+    std::vector < size_t > res (arr);
+    std::vector < double > dres (darr);
+    std::vector < std::string > sres (sarr);
+    std::sort (res.begin (), res.end ());
+    std::sort (dres.begin (), dres.end ());
+    std::sort (sres.begin (), sres.end ());
+
+    ShellSort (arr, g);
+    ShellSort (darr, g);
+    ShellSort (sarr, g);
+    ASSERT_EQ(1, arr == res);
+    ASSERT_EQ(1, darr == dres);
+    ASSERT_EQ(1, sarr == sres);
+  }
+}
+
+/**
+ *
+ * RadixSortTest
+ * 
+ */
+TEST(RadixSortTest, NULLTest)
+{
+  std::vector < Key128 > arr;
+  EXPECT_NO_THROW(RadixSort128 (arr));
+}
+
+// (hash, timestamp) pairs with plenty of repeated hashes
+TEST(RadixSortTest, Key128)
+{
+  std::mt19937_64 gen (33);
+  std::vector < Key128 > arr (50000);
+  for (auto &el : arr)
+  {
+    el.hi = gen () % 1000 * 0x9E3779B97F4A7C15ULL;
+    el.lo = gen () % 100000;
+  }
+  std::vector < Key128 > res (arr);
+  std::sort (res.begin (), res.end ());
+  RadixSort128 (arr);
+  ASSERT_EQ(1, arr == res);
+}
+
+// Composite key over a padded struct, a bytewise UUID field and stability
+TEST(RadixSortTest, Records)
+{
+  struct Record
+  {
+    uint16_t shard;
+    unsigned char uuid[6];
+    uint32_t id;
+    uint32_t seq;
+  };
+  std::mt19937_64 gen (33);
+  std::vector < Record > arr (20000);
+  for (size_t i = 0; i < arr.size (); i++)
+  {
+    arr[i].shard = gen () % 3;
+    for (auto &b : arr[i].uuid)
+      b = gen () % 2 ? 0xAB : gen () % 256;
+    arr[i].id = gen () % 50;
+    arr[i].seq = i;
+  }
+  std::vector < Record > res (arr);
+  std::stable_sort (res.begin (), res.end (),
+      [](const Record &a, const Record &b)
+      {
+        if (a.shard != b.shard) return a.shard < b.shard;
+        int c = memcmp (a.uuid, b.uuid, sizeof(a.uuid));
+        if (c) return c < 0;
+        return a.id < b.id;
+      });
+
+  std::vector < RadixKeyField > fields { RadixKeyField (
+      offsetof(Record, shard), 2), RadixKeyField (offsetof(Record, uuid), 6,
+      true), RadixKeyField (offsetof(Record, id), 4) };
+  RadixSortRecords (arr, fields);
+  for (size_t i = 0; i < arr.size (); i++)
+    ASSERT_EQ(res[i].seq, arr[i].seq);
+
+  std::vector < RadixKeyField > bad { RadixKeyField (offsetof(Record, seq), 8) };
+  EXPECT_ANY_THROW(RadixSortRecords (arr, bad));
+}
+
+TEST(SpreadSortTest, NULLTest)
+{
+  std::vector < size_t > arr;
+  EXPECT_NO_THROW(SpreadSort (arr));
+  std::vector < double > darr;
+  EXPECT_NO_THROW(SpreadSort (darr));
+}
+
+TEST(SpreadSortTest, Correctness_100)
+{
+  std::vector < size_t > arr { 38, 98, 79, 69, 14, 76, 59, 2, 47, 3, 26, 99, 12,
+      52, 51, 22, 15, 1, 39, 18, 46, 44, 16, 50, 36, 72, 9, 100, 23, 37, 20, 89,
+      92, 5, 53, 74, 75, 56, 30, 88, 49, 87, 78, 94, 57, 48, 85, 31, 60, 90, 62,
+      27, 6, 61, 43, 21, 73, 7, 81, 63, 58, 24, 83, 86, 67, 25, 54, 68, 97, 28,
+      13, 95, 29, 40, 91, 65, 70, 66, 33, 55, 77, 41, 8, 71, 17, 64, 96, 45, 34,
+      84, 32, 19, 11, 10, 42, 35, 4, 80, 82, 93 };
+  SpreadSort (arr);
+  std::vector < size_t > res { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+      15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+      33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50,
+      51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68,
+      69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86,
+      87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100 };
+  ASSERT_EQ(1, arr == res);
+}
+
+TEST(SpreadSortTest, UniformAndSkewed)
+{
+  std::mt19937_64 gen (34);
+  std::exponential_distribution < double > exp (1.0);
+  for (int pattern = 0; pattern < 3; pattern++)
+  {
+    std::vector < size_t > arr (100000);
+    for (size_t i = 0; i < arr.size (); i++)
+    {
+      if (pattern == 0)
+        arr[i] = gen ();
+      else if (pattern == 1)
+        arr[i] = gen () % 500;
+      else
+        arr[i] = (size_t) (exp (gen) * 1e15);
+    }
+    /* a few extreme keys stretch the range the buckets are spread over */
+    arr[7] = 0;
+    arr[77] = SIZE_MAX;
+    std::vector < size_t > res = arr;
+    std::sort (res.begin (), res.end ());
+    SpreadSort (arr);
+    ASSERT_EQ(1, arr == res);
+  }
+}
+
+TEST(SpreadSortTest, Doubles)
+{
+  std::mt19937_64 gen (34);
+  std::uniform_real_distribution < double > uniform (-1e6, 1e6);
+  std::vector < double > arr (50000);
+  for (size_t i = 0; i < arr.size (); i++)
+  {
+    arr[i] = uniform (gen);
+  }
+  arr[1] = 0.0;
+  arr[2] = -0.0;
+  arr[3] = std::numeric_limits < double >::infinity ();
+  arr[4] = -std::numeric_limits < double >::infinity ();
+  arr[5] = std::numeric_limits < double >::denorm_min ();
+  std::vector < double > res = arr;
+  std::sort (res.begin (), res.end ());
+  SpreadSort (arr);
+  ASSERT_EQ(1, arr == res);
+  for (size_t i = 0; i + 1 < arr.size (); i++)
+  {
+    if (arr[i] == 0.0 && arr[i + 1] == 0.0)
+    {
+      ASSERT_EQ(1, std::signbit (arr[i]) && !std::signbit (arr[i + 1]));
+    }
+  }
+}
+
+TEST(SortUniqueTest, NULLTest)
+{
+  std::vector < size_t > arr;
+  EXPECT_NO_THROW(SortUnique (arr));
+  std::vector < std::pair < size_t, size_t > > counts;
+  EXPECT_NO_THROW(SortCount (arr, counts));
+  ASSERT_EQ(0, counts.size ());
+}
+
+TEST(SortUniqueTest, Unique)
+{
+  std::mt19937_64 gen (35);
+  /* small range takes the counting path, the wide ones the bucketed sort */
+  size_t ranges[] = { 50, 1000, 100000, SIZE_MAX };
+  size_t sizes[] = { 1, 2, 31, 33, 20000 };
+  for (size_t r = 0; r < sizeof (ranges) / sizeof (ranges[0]); r++)
+  {
+    for (size_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+    {
+      std::vector < size_t > arr (sizes[s]);
+      for (size_t i = 0; i < arr.size (); i++)
+      {
+        arr[i] = ranges[r] == SIZE_MAX ? gen () % 5000 * 0x100000001ULL : gen () % ranges[r];
+      }
+      std::vector < size_t > res = arr;
+      std::sort (res.begin (), res.end ());
+      res.erase (std::unique (res.begin (), res.end ()), res.end ());
+      SortUnique (arr);
+      ASSERT_EQ(1, arr == res);
+    }
+  }
+}
+
+TEST(SortUniqueTest, Count)
+{
+  std::mt19937_64 gen (35);
+  size_t ranges[] = { 50, 1000, 100000, SIZE_MAX };
+  size_t sizes[] = { 1, 2, 31, 33, 20000 };
+  for (size_t r = 0; r < sizeof (ranges) / sizeof (ranges[0]); r++)
+  {
+    for (size_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+    {
+      std::vector < size_t > arr (sizes[s]);
+      for (size_t i = 0; i < arr.size (); i++)
+      {
+        arr[i] = ranges[r] == SIZE_MAX ? gen () % 5000 * 0x100000001ULL : gen () % ranges[r];
+      }
+      std::map < size_t, size_t > expected;
+      for (size_t i = 0; i < arr.size (); i++)
+      {
+        expected[arr[i]]++;
+      }
+      std::vector < std::pair < size_t, size_t > > res (expected.begin (), expected.end ());
+      std::vector < std::pair < size_t, size_t > > counts;
+      SortCount (arr, counts);
+      ASSERT_EQ(1, counts == res);
+    }
+  }
+}
+
+TEST(SortCatalogTest, Names)
+{
+  for (int i = 0; i < INPUT_COUNT; i++)
+  {
+    SortInput input;
+    ASSERT_EQ(1, ParseSortInput (SortInputName ((SortInput) i), input));
+    ASSERT_EQ(i, input);
+  }
+  SortInput input;
+  ASSERT_EQ(0, ParseSortInput ("no-such-input", input));
+  ASSERT_EQ(1, FindSortAlgorithm ("MergeSort") != nullptr);
+  ASSERT_EQ(1, FindSortAlgorithm ("NoSuchSort") == nullptr);
+}
+
+TEST(SortCatalogTest, Median3Killer)
+{
+  for (size_t N = 0; N < 50; N++)
+  {
+    std::vector < size_t > arr;
+    GenerateSortInput (INPUT_MEDIAN3_KILLER, N, 36, arr);
+    std::sort (arr.begin (), arr.end ());
+    for (size_t i = 0; i < N; i++)
+    {
+      ASSERT_EQ(i + 1, arr[i]);
+    }
+  }
+  std::vector < size_t > arr;
+  GenerateSortInput (INPUT_MEDIAN3_KILLER, 12, 36, arr);
+  std::vector < size_t > res { 1, 7, 3, 9, 5, 11, 2, 4, 6, 8, 10, 12 };
+  ASSERT_EQ(1, arr == res);
+}
+
+TEST(SortCatalogTest, AllAlgorithmsAllInputs)
+{
+  const std::vector < SortAlgorithm > & algorithms = SortAlgorithms ();
+  size_t sizes[] = { 0, 1, 2, 3, 500 };
+  for (size_t a = 0; a < algorithms.size (); a++)
+  {
+    for (int i = 0; i < INPUT_COUNT; i++)
+    {
+      for (size_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+      {
+        std::vector < size_t > arr;
+        GenerateSortInput ((SortInput) i, sizes[s], 36, arr);
+        std::vector < size_t > res = arr;
+        std::sort (res.begin (), res.end ());
+        if (algorithms[a].maxKey && !arr.empty () && res.back () > algorithms[a].maxKey)
+        {
+          ASSERT_THROW(algorithms[a].sort (arr), std::string) << algorithms[a].name;
+          continue;
+        }
+        algorithms[a].sort (arr);
+        ASSERT_EQ(1, arr == res) << algorithms[a].name << " " << SortInputName ((SortInput) i);
+      }
+    }
+  }
+}
+
+TEST(SortInstrumentTest, CountedKey)
+{
+  std::mt19937_64 gen (38);
+  std::vector < CountedKey < size_t > > arr;
+  std::vector < size_t > res;
+  for (size_t i = 0; i < 1000; i++)
+  {
+    res.push_back (gen () % 500);
+    arr.push_back (CountedKey < size_t > (res.back ()));
+  }
+  std::sort (res.begin (), res.end ());
+  ResetSortCounters ();
+  std::sort (arr.begin (), arr.end ());
+  SortCounters counters = ThreadSortCounters ();
+  /* n log n comparisons give or take, nowhere near n^2 */
+  ASSERT_EQ(1, counters.comparisons > 1000 && counters.comparisons < 50000);
+  ASSERT_EQ(1, counters.moves + counters.swaps > 0);
+  for (size_t i = 0; i < res.size (); i++)
+  {
+    ASSERT_EQ(res[i], arr[i].get ());
+  }
+}
+
+TEST(SortInstrumentTest, QuickSortSorted)
+{
+  std::vector < size_t > arr (100);
+  for (size_t i = 0; i < arr.size (); i++)
+  {
+    arr[i] = i;
+  }
+  ResetSortCounters ();
+  QuickSort (arr, 0, arr.size () - 1);
+  SortCounters counters = ThreadSortCounters ();
+  if (SortInstrumentEnabled ())
+  {
+    /* the last element pivot compares against everything left every time */
+    ASSERT_EQ(4950, counters.comparisons);
+    ASSERT_EQ(1, counters.maxDepth >= 100);
+    ASSERT_EQ(0, counters.depth);
+  }
+  else
+  {
+    /* counters compile out */
+    ASSERT_EQ(0, counters.comparisons + counters.swaps + counters.moves + counters.maxDepth);
+  }
+}
+
+TEST(PerfCountersTest, StartStop)
+{
+  PerfCounters counters;
+  std::vector < size_t > arr (1000);
+  for (size_t i = 0; i < arr.size (); i++)
+  {
+    arr[i] = (i * 7919) % 1009;
+  }
+  counters.Start ();
+  MergeSort (arr, 0, arr.size () - 1);
+  PerfSample sample = counters.Stop ();
+  ASSERT_EQ(1, std::is_sorted (arr.begin (), arr.end ()));
+  bool any = false;
+  for (int e = 0; e < PERF_EVENT_COUNT; e++)
+  {
+    /* unavailable events must read as zero, not garbage */
+    if (!sample.valid[e])
+    {
+      ASSERT_EQ(0u, sample.value[e]);
+    }
+    any = any || sample.valid[e];
+  }
+  ASSERT_EQ(counters.Available (), any);
+  ASSERT_NE(std::string::npos, PerfCounters::Describe (sample, 1e-3).find ("dtlb-misses"));
+}
+
+TEST(LatencyHistogramTest, Percentiles)
+{
+  LatencyHistogram histogram;
+  ASSERT_EQ(0u, histogram.Percentile (0.5));
+  for (uint64_t v = 1; v <= 100; v++)
+  {
+    histogram.Record (v);
+  }
+  /* exact below 128 */
+  ASSERT_EQ(50u, histogram.Percentile (0.5));
+  ASSERT_EQ(99u, histogram.Percentile (0.99));
+  ASSERT_EQ(100u, histogram.Percentile (1.0));
+  ASSERT_EQ(1u, histogram.Min ());
+
+  histogram.Clear ();
+  std::mt19937_64 rng (40);
+  std::vector < uint64_t > values (10000);
+  for (size_t i = 0; i < values.size (); i++)
+  {
+    values[i] = rng () >> (rng () % 64);
+    histogram.Record (values[i]);
+  }
+  std::sort (values.begin (), values.end ());
+  double qs[] = { 0.1, 0.5, 0.9, 0.99 };
+  for (size_t i = 0; i < 4; i++)
+  {
+    uint64_t exact = values[(size_t) std::ceil (qs[i] * values.size ()) - 1];
+    uint64_t approx = histogram.Percentile (qs[i]);
+    ASSERT_GE(approx, exact);
+    ASSERT_LE(approx - exact, exact / 64);
+  }
+  ASSERT_EQ(values.back (), histogram.Max ());
+}
+
+TEST(LatencyRecorderTest, Threads)
+{
+  LatencyRecorder recorder;
+  std::vector < std::thread > threads;
+  for (unsigned t = 0; t < 4; t++)
+  {
+    threads.push_back (std::thread ([&recorder, t] ()
+    {
+      for (uint64_t i = 0; i < 1000; i++)
+      {
+        recorder.Record (t * 1000 + i);
+      }
+    }));
+  }
+  for (size_t t = 0; t < threads.size (); t++)
+  {
+    threads[t].join ();
+  }
+  {
+    ScopedTimer timer (recorder);
+  }
+  LatencyHistogram merged = recorder.Merged ();
+  ASSERT_EQ(4001u, merged.Count ());
+  ASSERT_EQ(0u, merged.Min ());
+  ASSERT_LE(3999u, merged.Max ());
+  ASSERT_LT(0, CycleClock::NsPerTick ());
+}
+
+TEST(FastWriterTest, Format)
+{
+  uint64_t values[] = { 0, 9, 10, 99, 100, 999, 1000, 12345678, 10000000000000000000ull,
+      std::numeric_limits < uint64_t >::max () };
+  char out[24];
+  for (size_t i = 0; i < sizeof (values) / sizeof (values[0]); i++)
+  {
+    size_t length = FastWriter::Format (out, values[i]);
+    ASSERT_EQ(std::to_string (values[i]), std::string (out, length));
+  }
+}
+
+TEST(FastWriterTest, TextAndBinary)
+{
+  std::mt19937_64 rng (41);
+  std::vector < uint64_t > arr (100000);
+  std::ostringstream expected;
+  for (size_t i = 0; i < arr.size (); i++)
+  {
+    arr[i] = rng () >> (rng () % 64);
+    expected << arr[i] << " ";
+  }
+  expected << "\n" << -42 << std::numeric_limits < int64_t >::min ();
+  expected << 7 << -7 << 8u << (size_t) 9 << -10L << 11ULL << (short) -12;
+
+  FILE * file = tmpfile ();
+  ASSERT_NE((FILE *) NULL, file);
+  {
+    /* a small buffer forces many flushes */
+    FastWriter out (fileno (file), 100);
+    out.WriteText (arr.data (), arr.size (), ' ');
+    out.Write ('\n');
+    out.Write ((int64_t) -42);
+    out.Write (std::numeric_limits < int64_t >::min ());
+    /* every integer type picks an overload */
+    out.Write (7);
+    out.Write (-7);
+    out.Write (8u);
+    out.Write ((size_t) 9);
+    out.Write (-10L);
+    out.Write (11ULL);
+    out.Write ((short) -12);
+    out.WriteBinary (arr.data (), arr.size ());
+  }
+  std::string text = expected.str ();
+  std::vector < char > data (text.size () + arr.size () * sizeof (uint64_t) + 1);
+  rewind (file);
+  ASSERT_EQ(data.size () - 1, fread (data.data (), 1, data.size (), file));
+  fclose (file);
+  ASSERT_EQ(text, std::string (data.data (), text.size ()));
+  ASSERT_EQ(0, memcmp (arr.data (), data.data () + text.size (), arr.size () * sizeof (uint64_t)));
+}
+
+TEST(FastReaderTest, ParseKeys)
+{
+  std::vector < uint64_t > keys;
+  std::string text = "0 7\n12345678,123456789\t\t18446744073709551615\r\n00042   99999999 1";
+  ASSERT_EQ(8u, ParseKeys (text.data (), text.data () + text.size (), keys));
+  std::vector < uint64_t > res = { 0, 7, 12345678, 123456789, 18446744073709551615ull, 42, 99999999, 1 };
+  ASSERT_EQ(1, keys == res);
+
+  std::string overflow = "18446744073709551616 1 2 3 4 5 6 7";
+  ASSERT_THROW(ParseKeys (overflow.data (), overflow.data () + overflow.size (), keys), std::string);
+  std::string bad = "12 -3 4 5 6 7 8 9 10";
+  ASSERT_THROW(ParseKeys (bad.data (), bad.data () + bad.size (), keys), std::string);
+  std::string glued = "123456789012a 1 2 3 4 5";
+  ASSERT_THROW(ParseKeys (glued.data (), glued.data () + glued.size (), keys), std::string);
+}
+
+TEST(FastReaderTest, Files)
+{
+  std::mt19937_64 rng (42);
+  std::vector < uint64_t > arr (200000);
+  for (size_t i = 0; i < arr.size (); i++)
+  {
+    arr[i] = rng () >> (rng () % 64);
+  }
+  char path[] = "/tmp/fastreaderXXXXXX";
+  int fd = mkstemp (path);
+  ASSERT_LE(0, fd);
+
+  std::vector < uint64_t > keys;
+  WriteArray (fd, arr, false);
+  ReadTextKeys (path, keys);
+  ASSERT_EQ(1, keys == arr);
+
+  ASSERT_EQ(0, ftruncate (fd, 0));
+  ASSERT_EQ(0, lseek (fd, 0, SEEK_SET));
+  WriteArray (fd, arr, true);
+  ReadBinaryKeys (path, keys);
+  ASSERT_EQ(1, keys == arr);
+  ASSERT_EQ(1, IsRegularFile (path));
+  ASSERT_EQ(0, IsRegularFile ("-"));
+  {
+    MappedFile file (path);
+    ASSERT_EQ(arr.size (), file.KeyCount ());
+    ASSERT_EQ(1, std::equal (arr.begin (), arr.end (), file.Keys ()));
+  }
+  close (fd);
+  unlink (path);
+  ASSERT_EQ(0, IsRegularFile (path));
+  ASSERT_THROW(ReadTextKeys (path, keys), std::string);
+}
+
+TEST(InPlaceSortTest, AllInputs)
+{
+  size_t sizes[] = { 0, 1, 2, 17, 1000, 20000 };
+  for (int in = 0; in < INPUT_COUNT; in++)
+  {
+    for (size_t s = 0; s < 6; s++)
+    {
+      std::vector < size_t > arr;
+      GenerateSortInput ((SortInput) in, sizes[s], 43, arr);
+      std::vector < size_t > res (arr);
+      std::sort (res.begin (), res.end ());
+      std::vector < uint64_t > quick (arr.begin (), arr.end ()), heap (quick);
+      std::vector < uint32_t > quick32 (arr.begin (), arr.end ()), heap32 (quick32);
+      QuickSort (quick.data (), quick.data () + quick.size ());
+      HeapSort (heap.data (), heap.data () + heap.size ());
+      QuickSort (quick32.data (), quick32.data () + quick32.size ());
+      HeapSort (heap32.data (), heap32.data () + heap32.size ());
+      ASSERT_EQ(1, std::equal (res.begin (), res.end (), quick.begin ())) << SortInputName ((SortInput) in);
+      ASSERT_EQ(1, std::equal (res.begin (), res.end (), heap.begin ())) << SortInputName ((SortInput) in);
+      ASSERT_EQ(1, std::is_sorted (quick32.begin (), quick32.end ()));
+      ASSERT_EQ(1, std::is_sorted (heap32.begin (), heap32.end ()));
+    }
+  }
+}
+
+TEST(MappedSortTest, SortFile)
+{
+  std::mt19937_64 rng (43);
+  std::vector < uint32_t > keys (100000);
+  for (size_t i = 0; i < keys.size (); i++)
+  {
+    keys[i] = (uint32_t) rng ();
+  }
+  char path[] = "/tmp/mappedsortXXXXXX";
+  int fd = mkstemp (path);
+  ASSERT_LE(0, fd);
+  ASSERT_EQ((ssize_t) (keys.size () * 4), write (fd, keys.data (), keys.size () * 4));
+
+  ASSERT_EQ(keys.size (), SortMappedFile (path, 4, MAPPED_HEAP_SORT));
+  std::vector < uint32_t > sorted (keys.size ());
+  ASSERT_EQ((ssize_t) (keys.size () * 4), pread (fd, sorted.data (), keys.size () * 4, 0));
+  std::sort (keys.begin (), keys.end ());
+  ASSERT_EQ(1, sorted == keys);
+
+  /* 400000 bytes also read as 50000 uint64 keys */
+  ASSERT_EQ(keys.size () / 2, SortMappedFile (path, 8, MAPPED_QUICK_SORT));
+  std::vector < uint64_t > wide (keys.size () / 2);
+  ASSERT_EQ((ssize_t) (keys.size () * 4), pread (fd, wide.data (), keys.size () * 4, 0));
+  ASSERT_EQ(1, std::is_sorted (wide.begin (), wide.end ()));
+
+  ASSERT_EQ(0, ftruncate (fd, 6));
+  ASSERT_THROW(SortMappedFile (path, 4, MAPPED_QUICK_SORT), std::string);
+  ASSERT_THROW(SortMappedFile (path, 2, MAPPED_QUICK_SORT), std::string);
+  close (fd);
+  unlink (path);
+}
+
+TEST(RandomFillTest, ThreadsDoNotChangeKeys)
+{
+  size_t N = 5 * RANDOM_CHUNK + 123;
+  std::vector < uint64_t > one (N), four (N);
+  ParallelFill (one.data (), N, 44, UniformKeys (), 1);
+  ParallelFill (four.data (), N, 44, UniformKeys (), 4);
+  ASSERT_EQ(1, one == four);
+  /* chunks come from different streams */
+  ASSERT_NE(one[0], one[RANDOM_CHUNK]);
+
+  ParallelFill (one.data (), N, 44, NormalKeys (1000000, 100), 1);
+  ParallelFill (four.data (), N, 44, NormalKeys (1000000, 100), 3);
+  ASSERT_EQ(1, one == four);
+
+  Xoshiro256 a (44), b (44);
+  b.Jump ();
+  ASSERT_NE(a (), b ());
+}
+
+TEST(RandomFillTest, Distributions)
+{
+  size_t N = 1000000;
+  std::vector < uint64_t > keys (N);
+  ParallelFill (keys.data (), N, 44, BoundedKeys (10));
+  std::vector < size_t > counts (10, 0);
+  for (size_t i = 0; i < N; i++)
+  {
+    ASSERT_LT(keys[i], 10u);
+    counts[keys[i]]++;
+  }
+  for (size_t k = 0; k < 10; k++)
+  {
+    ASSERT_NEAR(0.1, (double) counts[k] / N, 0.005);
+  }
+
+  ParallelFill (keys.data (), N, 44, NormalKeys (1000000, 1000));
+  double mean = 0, squares = 0;
+  for (size_t i = 0; i < N; i++)
+  {
+    mean += keys[i];
+  }
+  mean /= N;
+  for (size_t i = 0; i < N; i++)
+  {
+    squares += (keys[i] - mean) * (keys[i] - mean);
+  }
+  ASSERT_NEAR(1000000, mean, 10);
+  ASSERT_NEAR(1000, std::sqrt (squares / N), 10);
+
+  /* Zipf(1) over 100 ranks: P(rank 0) = 1 / H(100), P(rank 1) half of it */
+  ParallelFill (keys.data (), N, 44, ZipfKeys (100, 1.0));
+  double harmonic = 0;
+  for (int k = 1; k <= 100; k++)
+  {
+    harmonic += 1.0 / k;
+  }
+  size_t first = 0, second = 0;
+  for (size_t i = 0; i < N; i++)
+  {
+    ASSERT_LT(keys[i], 100u);
+    first += keys[i] == 0;
+    second += keys[i] == 1;
+  }
+  ASSERT_NEAR(1 / harmonic, (double) first / N, 0.005);
+  ASSERT_NEAR(0.5 / harmonic, (double) second / N, 0.005);
+}
+
+TEST(SortVerifyTest, SortedPermutation)
+{
+  std::vector < size_t > arr;
+  GenerateSortInput (INPUT_UNIFORM, 1 << 20, 45, arr);
+  MultisetHash input = HashKeys (arr.data (), arr.size ());
+  ASSERT_EQ(0, VerifySort (arr, input));
+  std::sort (arr.begin (), arr.end ());
+  ASSERT_EQ(1, VerifySort (arr, input));
+  /* the hash does not depend on how the work is split */
+  ASSERT_EQ(1, HashKeys (arr.data (), arr.size (), 1) == HashKeys (arr.data (), arr.size (), 4));
+
+  SortCheck check = VerifySorted (arr.data (), arr.size (), 4);
+  ASSERT_EQ(1, check.sorted);
+  ASSERT_EQ(arr.size (), check.firstUnsorted);
+  ASSERT_EQ(arr.size (), check.hash.count);
+
+  /* still sorted, but a key changed */
+  arr.back ()++;
+  ASSERT_EQ(0, VerifySort (arr, input));
+  arr.back ()--;
+  /* a duplicate replacing a key */
+  arr[1000] = arr[999];
+  ASSERT_EQ(0, VerifySort (arr, input));
+}
+
+TEST(SortVerifyTest, FirstUnsorted)
+{
+  std::vector < size_t > arr (1 << 20);
+  for (size_t i = 0; i < arr.size (); i++)
+  {
+    arr[i] = i;
+  }
+  /* right at the start of the second of four chunks, and later in the third */
+  size_t positions[] = { arr.size () / 4, arr.size () / 2 + 17, 1 };
+  for (size_t p = 0; p < 3; p++)
+  {
+    std::swap (arr[positions[p] - 1], arr[positions[p]]);
+    SortCheck check = VerifySorted (arr.data (), arr.size (), 4);
+    ASSERT_EQ(0, check.sorted);
+    ASSERT_EQ(positions[p], check.firstUnsorted);
+    std::swap (arr[positions[p] - 1], arr[positions[p]]);
+  }
+  ASSERT_EQ(1, VerifySorted (arr.data (), 0).sorted);
+  ASSERT_EQ(1, VerifySorted (arr.data (), 1).sorted);
+}
+
 int
 main (int argc, char **argv)
 {
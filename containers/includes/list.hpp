@@ -27,19 +27,36 @@
 #ifndef _LIST_HPP_ 
 #define _LIST_HPP_
 
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <cstdbool>
+#include <functional>
 #include <type_traits>
+#include <utility>
+#include "node_pool.hpp"
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define _LIST_HAVE_PMR_ 1
+#endif
+#endif
 
 namespace miniSTL
 {
 
-  /* For time being we are skipping allocator */
-  template<class T>
+  /* nodes come from a slab pool owned by each list (see
+   node_pool.hpp), the pool takes its slabs from Allocator
+   rebound to its slot type. Elements are constructed through
+   allocator_traits so scoped allocators reach them as well */
+  template<class T, class Allocator = std::allocator<T>>
     class list
     {
 
       struct node;
+      typedef std::allocator_traits<Allocator> alloc_traits;
     public:
 
       /* should iterators be aggregates? */
@@ -53,7 +70,7 @@ namespace miniSTL
             iter_node (val)
         {
         }
-        friend class list<T> ;
+        friend class list;
         using iterator_category = std::input_iterator_tag;
         using difference_type = std::ptrdiff_t;
         using value_type = T;
@@ -125,6 +142,7 @@ namespace miniSTL
       typedef value_type *reverse_iterator;
       typedef const reverse_iterator const_reverse_iterator;
       typedef size_t size_type;
+      typedef Allocator allocator_type;
 
       /* I need to be truthful here. I copied this snippet from SO. 
        My understanding here is that during template instantiation,
@@ -145,12 +163,13 @@ namespace miniSTL
       /**
        * default constructor for a list
        *
-       * @param  : none
+       * @param  : const allocator_type& - allocator the
+       *           nodes are taken from
        * @return : none
        */
       explicit
-      list () :
-          m_head (nullptr), m_tail (nullptr), m_size (0)
+      list (const allocator_type &alloc = allocator_type ()) :
+          m_head (nullptr), m_tail (nullptr), m_size (0), m_pool (alloc)
       {
 
       }
@@ -162,11 +181,13 @@ namespace miniSTL
        * all n elements
        *
        * @param  : size_t - number of elements to add to list
+       *         : const allocator_type& - allocator the
+       *           nodes are taken from
        * @return : none
        */
       explicit
-      list (size_type n) :
-          m_head (nullptr), m_tail (nullptr), m_size (0)
+      list (size_type n, const allocator_type &alloc = allocator_type ()) :
+          m_head (nullptr), m_tail (nullptr), m_size (0), m_pool (alloc)
       {
         /// allocate n nodes with value zero ///
         for (size_type i = 0; i < n; i++)
@@ -183,10 +204,13 @@ namespace miniSTL
        * 
        * @param  : size_t - number of elements to add to list
        *         : T&     - value to initialize each element with 
+       *         : const allocator_type& - allocator the
+       *           nodes are taken from
        * @return : none
        */
-      list (size_type n, const value_type &val) :
-          m_head (nullptr), m_tail (nullptr), m_size (0)
+      list (size_type n, const value_type &val, const allocator_type &alloc =
+                allocator_type ()) :
+          m_head (nullptr), m_tail (nullptr), m_size (0), m_pool (alloc)
       {
         for (size_type i = 0; i < n; i++)
         {
@@ -204,12 +228,15 @@ namespace miniSTL
        *           the start of the range
        *         : InputIterator - any iteratable type object denoting 
        *           the end of the range
+       *         : const allocator_type& - allocator the
+       *           nodes are taken from
        * @return : none
        */
       template<class InputIterator, typename = RequireInputIterator<
           InputIterator>>
-        list (InputIterator first, InputIterator last) :
-            m_head (nullptr), m_tail (nullptr), m_size (0)
+        list (InputIterator first, InputIterator last,
+              const allocator_type &alloc = allocator_type ()) :
+            m_head (nullptr), m_tail (nullptr), m_size (0), m_pool (alloc)
         {
           assign (first, last);
         }
@@ -221,7 +248,9 @@ namespace miniSTL
        * @return : none
        */
       list (const list &x) :
-          m_head (nullptr), m_tail (nullptr), m_size (0)
+          m_head (nullptr), m_tail (nullptr), m_size (0), m_pool (
+              alloc_traits::select_on_container_copy_construction (
+                  x.get_allocator ()))
       {
         /// Do a deep copy ///
         for (auto &el : x)
@@ -230,18 +259,65 @@ namespace miniSTL
         }
       }
 
+      /**
+       * copy constructor for a list using a given allocator
+       *
+       * @param  : list& - list object from where we need to copy
+       *         : const allocator_type& - allocator the
+       *           nodes are taken from
+       * @return : none
+       */
+      list (const list &x, const allocator_type &alloc) :
+          m_head (nullptr), m_tail (nullptr), m_size (0), m_pool (alloc)
+      {
+        for (auto &el : x)
+        {
+          push_back (el);
+        }
+      }
+
       /**
        * move constructor for a list
        *
        * @param  : list&& - the list object from where we need to move
        * @return : none
        */
-      list (list &&x)
+      list (list &&x) :
+          m_head (x.m_head), m_tail (x.m_tail), m_size (x.m_size), m_pool (
+              std::move (x.m_pool))
       {
-        m_head = x.m_head;
-        m_tail = x.m_tail;
-        m_size = x.m_size;
+        /* the nodes live in x's slabs, so the pool moves with them */
         x.m_head = x.m_tail = nullptr;
+        x.m_size = 0;
+      }
+
+      /**
+       * move constructor for a list using a given allocator.
+       * Nodes are only taken over when the allocators compare
+       * equal, otherwise the elements are moved one by one
+       *
+       * @param  : list&& - the list object from where we need to move
+       *         : const allocator_type& - allocator the
+       *           nodes are taken from
+       * @return : none
+       */
+      list (list &&x, const allocator_type &alloc) :
+          m_head (nullptr), m_tail (nullptr), m_size (0), m_pool (alloc)
+      {
+        if (get_allocator () == x.get_allocator ())
+        {
+          m_pool.swap (x.m_pool);
+          std::swap (m_head, x.m_head);
+          std::swap (m_tail, x.m_tail);
+          std::swap (m_size, x.m_size);
+        }
+        else
+        {
+          for (auto &el : x)
+          {
+            push_back (std::move (el));
+          }
+        }
       }
 
       /**
@@ -249,10 +325,13 @@ namespace miniSTL
        *
        * @param  : std::initializer_list<value_type> - initializer
        *           list from where we need to copy values to our list
+       *         : const allocator_type& - allocator the
+       *           nodes are taken from
        * @return : none
        */
-      list (std::initializer_list<value_type> il) :
-          m_head (nullptr), m_tail (nullptr), m_size (0)
+      list (std::initializer_list<value_type> il,
+            const allocator_type &alloc = allocator_type ()) :
+          m_head (nullptr), m_tail (nullptr), m_size (0), m_pool (alloc)
       {
         assign (il.begin (), il.end ());
       }
@@ -267,7 +346,9 @@ namespace miniSTL
        */
       ~list ()
       {
-        erase (begin (), end ());
+        /* elements are destroyed in place, the slabs are then
+         released by the pool in one go instead of node by node */
+        destroy_nodes ();
       }
 
       /// assignment operator ///
@@ -287,6 +368,8 @@ namespace miniSTL
           return *this;
         }
 
+        copy_allocator (x,
+            typename alloc_traits::propagate_on_container_copy_assignment ());
         erase (begin (), end ());
 
         for (auto &el : x)
@@ -311,11 +394,26 @@ namespace miniSTL
           return *this;
         }
 
-        erase (begin (), end ());
+        if (!alloc_traits::propagate_on_container_move_assignment::value
+            && get_allocator () != x.get_allocator ())
+        {
+          /* x's slabs cannot be freed through our allocator,
+           so the elements have to move instead of the nodes */
+          erase (begin (), end ());
+          for (auto &el : x)
+          {
+            push_back (std::move (el));
+          }
+          return *this;
+        }
+
+        destroy_nodes ();
+        m_pool.adopt (x.m_pool);
         m_head = x.m_head;
         m_tail = x.m_tail;
         m_size = x.m_size;
         x.m_head = x.m_tail = nullptr;
+        x.m_size = 0;
         return *this;
       }
 
@@ -534,7 +632,7 @@ namespace miniSTL
       void
       push_front (const value_type &val)
       {
-        node *cur_node = new node (val);
+        node *cur_node = create_node (val);
         push_front_helper (cur_node);
       }
 
@@ -550,7 +648,7 @@ namespace miniSTL
       void
       push_front (value_type &&val)
       {
-        node *cur_node = new node (std::move (val));
+        node *cur_node = create_node (std::move (val));
         push_front_helper (cur_node);
       }
 
@@ -572,7 +670,11 @@ namespace miniSTL
         {
           m_head->prev = nullptr;
         }
-        delete cur_node;
+        else
+        {
+          m_tail = nullptr;
+        }
+        destroy_node (cur_node);
         m_size--;
       }
 
@@ -588,7 +690,7 @@ namespace miniSTL
       void
       push_back (const value_type &val)
       {
-        node *cur_node = new node (val);
+        node *cur_node = create_node (val);
         push_back_helper (cur_node);
       }
 
@@ -604,7 +706,7 @@ namespace miniSTL
       void
       push_back (value_type &&val)
       {
-        node *cur_node = new node (std::move (val));
+        node *cur_node = create_node (std::move (val));
         push_back_helper (cur_node);
       }
 
@@ -626,7 +728,11 @@ namespace miniSTL
         {
           m_tail->next = nullptr;
         }
-        delete cur_node;
+        else
+        {
+          m_head = nullptr;
+        }
+        destroy_node (cur_node);
         m_size--;
       }
 
@@ -644,7 +750,7 @@ namespace miniSTL
         node *cur_node = position.iter_node, *prev_node = cur_node->prev;
         /* we are not handling a bad iterator being passed case */
 
-        node *new_node = new node (val);
+        node *new_node = create_node (val);
         if (prev_node)
         {
           new_node->prev = prev_node;
@@ -683,7 +789,7 @@ namespace miniSTL
         node *cur_node = position.iter_node, *prev_node = cur_node->prev,
             *new_node = nullptr, *ret_node = nullptr;
 
-        new_node = new node (val);
+        new_node = create_node (val);
         if (prev_node)
         {
           new_node->prev = prev_node;
@@ -699,7 +805,7 @@ namespace miniSTL
 
         while (n - 1)
         {
-          new_node = new node (val);
+          new_node = create_node (val);
           new_node->prev = prev_node;
           prev_node->next = new_node;
           prev_node = new_node;
@@ -733,7 +839,7 @@ namespace miniSTL
           node *cur_node = position.iter_node, *prev_node = cur_node->prev,
               *new_node = nullptr, *ret_node = nullptr;
           int p_size = std::distance (first, last);
-          new_node = new node (*first++);
+          new_node = create_node (*first++);
           if (prev_node)
           {
             new_node->prev = prev_node;
@@ -749,7 +855,7 @@ namespace miniSTL
 
           while (first != last)
           {
-            new_node = new node (*first++);
+            new_node = create_node (*first++);
             new_node->prev = prev_node;
             prev_node->next = new_node;
             prev_node = new_node;
@@ -775,7 +881,7 @@ namespace miniSTL
         node *cur_node = position.iter_node, *prev_node = cur_node->prev;
         /* we are not handling a bad iterator being passed case */
 
-        node *new_node = new node (std::move (val));
+        node *new_node = create_node (std::move (val));
         if (prev_node)
         {
           new_node->prev = prev_node;
@@ -842,7 +948,7 @@ namespace miniSTL
           /* We are erasing m_tail*/
           m_tail = prev_node;
         }
-        delete cur_node;
+        destroy_node (cur_node);
         m_size--;
         return iterator (ret_node);
       }
@@ -876,7 +982,7 @@ namespace miniSTL
         while (first_node != last_node)
         {
           temp_node = first_node->next;
-          delete first_node;
+          destroy_node (first_node);
           first_node = temp_node;
         }
 
@@ -914,6 +1020,20 @@ namespace miniSTL
         std::swap (m_head, x.m_head);
         std::swap (m_tail, x.m_tail);
         std::swap (m_size, x.m_size);
+        m_pool.swap (x.m_pool);
+      }
+
+      /**
+       * returns a copy of the allocator the list was
+       * constructed with
+       *
+       * @param  : none
+       * @return : allocator_type - the allocator
+       */
+      allocator_type
+      get_allocator () const noexcept
+      {
+        return allocator_type (m_pool.get_allocator ());
       }
 
       /**
@@ -956,12 +1076,477 @@ namespace miniSTL
 
       }
 
+      /**
+       * removes every element and hands all slabs back to
+       * the allocator
+       *
+       * @param  : none
+       * @return : none
+       */
       void
       clear () noexcept
       {
+        destroy_nodes ();
+        m_pool.release ();
+      }
+
+      /// Operations ///
+
+      /**
+       * moves every element of x before position. Nodes are
+       * relinked, nothing is copied and no iterator is
+       * invalidated, iterators into x now refer into this
+       * list. Constant time apart from handing x's slabs
+       * over, x must not be this list
+       *
+       * @param  : const_iterator - element to insert before,
+       *           end () appends
+       *         : list & - list to take the elements from
+       * @return : none
+       */
+      void
+      splice (const_iterator position, list &x)
+      {
+        if (this == &x || x.empty ())
+        {
+          return;
+        }
+        link_before (position.iter_node, x.m_head, x.m_tail);
+        m_size += x.m_size;
+        x.m_head = x.m_tail = nullptr;
+        x.m_size = 0;
+        /* x is empty now, so its slabs can simply become ours */
+        m_pool.absorb (x.m_pool);
+      }
+
+      void
+      splice (const_iterator position, list &&x)
+      {
+        splice (position, x);
+      }
+
+      /**
+       * moves the element at i from x before position. x may
+       * be this list
+       *
+       * @param  : const_iterator - element to insert before
+       *         : list & - list holding i
+       *         : const_iterator - element to move
+       * @return : none
+       */
+      void
+      splice (const_iterator position, list &x, const_iterator i)
+      {
+        node *cur_node = i.iter_node;
+        if (this == &x)
+        {
+          if (cur_node == position.iter_node
+              || cur_node->next == position.iter_node)
+          {
+            /* already in place */
+            return;
+          }
+        }
+        else
+        {
+          /* may throw, so before anything is relinked */
+          m_pool.share (x.m_pool);
+          x.m_size--;
+          m_size++;
+        }
+        x.unlink_nodes (cur_node, cur_node);
+        link_before (position.iter_node, cur_node, cur_node);
+      }
+
+      void
+      splice (const_iterator position, list &&x, const_iterator i)
+      {
+        splice (position, x, i);
+      }
+
+      /**
+       * moves the elements in [first, last) from x before
+       * position. Moving within the same list is constant
+       * time, from another list the range is counted to keep
+       * size () constant time. position must not be inside
+       * the range
+       *
+       * @param  : const_iterator - element to insert before
+       *         : list & - list holding the range
+       *         : const_iterator - first element to move
+       *         : const_iterator - element after the last one
+       * @return : none
+       */
+      void
+      splice (const_iterator position, list &x, const_iterator first,
+              const_iterator last)
+      {
+        if (first.iter_node == last.iter_node
+            || (this == &x && position.iter_node == last.iter_node))
+        {
+          return;
+        }
+        node *first_node = first.iter_node;
+        node *last_node = (last.iter_node != nullptr) ?
+            last.iter_node->prev : x.m_tail;
+        if (this != &x)
+        {
+          /* may throw, so before any size or link changes */
+          m_pool.share (x.m_pool);
+          size_type n = std::distance (first, last);
+          x.m_size -= n;
+          m_size += n;
+        }
+        x.unlink_nodes (first_node, last_node);
+        link_before (position.iter_node, first_node, last_node);
+      }
+
+      void
+      splice (const_iterator position, list &&x, const_iterator first,
+              const_iterator last)
+      {
+        splice (position, x, first, last);
+      }
+
+      /**
+       * removes every element equal to val
+       *
+       * @param  : const value_type& - value to remove
+       * @return : none
+       */
+      void
+      remove (const value_type &val)
+      {
+        /* val may be one of our elements, erase that last */
+        node *self = nullptr;
+        for (node *cur_node = m_head; cur_node != nullptr;)
+        {
+          node *next_node = cur_node->next;
+          if (cur_node->data == val)
+          {
+            if (std::addressof (cur_node->data) != std::addressof (val))
+            {
+              erase (iterator (cur_node));
+            }
+            else
+            {
+              self = cur_node;
+            }
+          }
+          cur_node = next_node;
+        }
+        if (self != nullptr)
+        {
+          erase (iterator (self));
+        }
+      }
+
+      /**
+       * removes every element for which pred holds
+       *
+       * @param  : Predicate - unary predicate on T
+       * @return : none
+       */
+      template<class Predicate>
+        void
+        remove_if (Predicate pred)
+        {
+          for (node *cur_node = m_head; cur_node != nullptr;)
+          {
+            node *next_node = cur_node->next;
+            if (pred (cur_node->data))
+            {
+              erase (iterator (cur_node));
+            }
+            cur_node = next_node;
+          }
+        }
+
+      /**
+       * removes all but the first element of every run of
+       * equal consecutive elements
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      unique ()
+      {
+        unique (std::equal_to<value_type> ());
+      }
+
+      /**
+       * removes all but the first element of every run of
+       * consecutive elements for which pred holds
+       *
+       * @param  : BinaryPredicate - called with the kept
+       *           element and the one after it
+       * @return : none
+       */
+      template<class BinaryPredicate>
+        void
+        unique (BinaryPredicate pred)
+        {
+          node *cur_node = m_head;
+          while (cur_node != nullptr && cur_node->next != nullptr)
+          {
+            if (pred (cur_node->data, cur_node->next->data))
+            {
+              erase (iterator (cur_node->next));
+            }
+            else
+            {
+              cur_node = cur_node->next;
+            }
+          }
+        }
+
+      /**
+       * merges the sorted list x into this sorted list. Both
+       * are walked once and the nodes relinked, nothing is
+       * allocated. Equal elements from this list stay ahead
+       * of those from x, x is left empty
+       *
+       * @param  : list & - sorted list to merge in
+       * @return : none
+       */
+      void
+      merge (list &x)
+      {
+        merge (x, std::less<value_type> ());
+      }
 
+      void
+      merge (list &&x)
+      {
+        merge (x, std::less<value_type> ());
       }
 
+      /**
+       * merges the list x, sorted by comp, into this list
+       * sorted by comp. Should comp throw, no element is lost,
+       * each one is left in one of the two lists
+       *
+       * @param  : list & - sorted list to merge in
+       *         : Compare - strict weak ordering on T
+       * @return : none
+       */
+      template<class Compare>
+        void
+        merge (list &x, Compare comp)
+        {
+          if (this == &x || x.empty ())
+          {
+            return;
+          }
+
+          node *first = m_head, *second = x.m_head, *prev_node = nullptr;
+          node **link = &m_head;
+          size_type moved = 0;
+          try
+          {
+            while (first != nullptr && second != nullptr)
+            {
+              node *taken;
+              if (comp (second->data, first->data))
+              {
+                taken = second;
+                second = second->next;
+                moved++;
+              }
+              else
+              {
+                taken = first;
+                first = first->next;
+              }
+              taken->prev = prev_node;
+              *link = taken;
+              link = &taken->next;
+              prev_node = taken;
+            }
+          }
+          catch (...)
+          {
+            /* comp threw with both lists unfinished. Our rest
+             goes back behind the merged part and x keeps the
+             rest of its own nodes, which needs the pools shared
+             once x's nodes are in here. If they cannot be, x's
+             rest comes over too */
+            *link = first;
+            first->prev = prev_node;
+            bool shared = moved == 0;
+            if (!shared)
+            {
+              try
+              {
+                m_pool.share (x.m_pool);
+                shared = true;
+              }
+              catch (...)
+              {
+              }
+            }
+            if (shared)
+            {
+              second->prev = nullptr;
+              x.m_head = second;
+              x.m_size -= moved;
+              m_size += moved;
+            }
+            else
+            {
+              m_tail->next = second;
+              second->prev = m_tail;
+              m_tail = x.m_tail;
+              m_size += x.m_size;
+              x.m_head = x.m_tail = nullptr;
+              x.m_size = 0;
+              m_pool.absorb (x.m_pool);
+            }
+            throw;
+          }
+
+          /* the rest of whichever list is left stays linked */
+          if (first != nullptr)
+          {
+            *link = first;
+            first->prev = prev_node;
+          }
+          else
+          {
+            *link = second;
+            second->prev = prev_node;
+            m_tail = x.m_tail;
+          }
+
+          m_size += x.m_size;
+          x.m_head = x.m_tail = nullptr;
+          x.m_size = 0;
+          m_pool.absorb (x.m_pool);
+        }
+
+      template<class Compare>
+        void
+        merge (list &&x, Compare comp)
+        {
+          merge (x, comp);
+        }
+
+      /**
+       * reverses the order of the elements by swapping the
+       * links of every node
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      reverse () noexcept
+      {
+        for (node *cur_node = m_head; cur_node != nullptr;)
+        {
+          node *next_node = cur_node->next;
+          std::swap (cur_node->next, cur_node->prev);
+          cur_node = next_node;
+        }
+        std::swap (m_head, m_tail);
+      }
+
+      /**
+       * sorts the list in ascending order. Nodes are
+       * relinked, no element is copied or moved and nothing
+       * is allocated. The sort is stable
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      sort ()
+      {
+        sort (std::less<value_type> ());
+      }
+
+      /**
+       * sorts the list by the given comparison, stable
+       *
+       * bottom-up merge sort as in libstdc++: every node is
+       * merged into a run of one and carried up through bins
+       * where bin i holds a sorted run of 2^i nodes, like
+       * incrementing a binary counter. Runs are chained on
+       * next only, prev and m_tail are fixed up once at the
+       * end. Should comp throw, the bins are linked back into
+       * the list, which keeps every element in some order
+       *
+       * @param  : Compare - strict weak ordering on T
+       * @return : none
+       */
+      template<class Compare>
+        void
+        sort (Compare comp)
+        {
+          if (m_head == m_tail)
+          {
+            return;
+          }
+
+          /* 64 bins take up to 2^64 - 1 nodes */
+          node *bins[64] = { };
+          size_type fill = 0;
+          node *cur_node = m_head;
+          node *carry = nullptr, *sorted = nullptr;
+          try
+          {
+            while (cur_node != nullptr)
+            {
+              carry = cur_node;
+              cur_node = cur_node->next;
+              carry->next = nullptr;
+
+              size_type i = 0;
+              for (; i < fill && bins[i] != nullptr; i++)
+              {
+                /* bins[i] holds earlier elements, it goes first */
+                merge_runs (bins[i], carry, comp);
+                carry = bins[i];
+                bins[i] = nullptr;
+              }
+              bins[i] = carry;
+              carry = nullptr;
+              if (i == fill)
+              {
+                fill++;
+              }
+            }
+
+            /* lower bins hold later elements */
+            for (size_type i = 0; i < fill; i++)
+            {
+              if (bins[i] != nullptr)
+              {
+                merge_runs (bins[i], sorted, comp);
+                sorted = bins[i];
+                bins[i] = nullptr;
+              }
+            }
+          }
+          catch (...)
+          {
+            /* put every node back in the list, runs first and
+             the part not reached yet last, like libstdc++
+             splices its bins back */
+            node *head = nullptr;
+            node **link = &head;
+            for (size_type i = 0; i < fill; i++)
+            {
+              link = append_run (link, bins[i]);
+            }
+            link = append_run (link, carry);
+            link = append_run (link, sorted);
+            *link = cur_node;
+            relink (head);
+            throw;
+          }
+          relink (sorted);
+        }
       iterator
       begin () noexcept
       {
@@ -1006,6 +1591,251 @@ namespace miniSTL
 
     private:
 
+      /**
+       * construct a node in storage taken from the pool
+       *
+       * @param  : Args&& - arguments forwarded to the node
+       *           constructor
+       * @return : node* - the new unlinked node
+       */
+      template<class ... Args>
+        node*
+        create_node (Args &&... args)
+        {
+          node *cur_node = ::new (m_pool.allocate ()) node ();
+          allocator_type alloc (get_allocator ());
+          try
+          {
+            alloc_traits::construct (alloc, std::addressof (cur_node->data),
+                                     std::forward<Args> (args)...);
+          }
+          catch (...)
+          {
+            m_pool.deallocate (cur_node);
+            throw;
+          }
+          return cur_node;
+        }
+
+      /**
+       * destroy a node and hand its storage back to the pool
+       *
+       * @param  : node* - an unlinked node
+       * @return : none
+       */
+      void
+      destroy_node (node *cur_node) noexcept
+      {
+        allocator_type alloc (get_allocator ());
+        alloc_traits::destroy (alloc, std::addressof (cur_node->data));
+        cur_node->~node ();
+        m_pool.deallocate (cur_node);
+      }
+
+      /**
+       * detach the nodes first to last, both included, from
+       * this list. Sizes are left to the caller
+       *
+       * @param  : node* - first node of the chain
+       *         : node* - last node of the chain
+       * @return : none
+       */
+      void
+      unlink_nodes (node *first, node *last) noexcept
+      {
+        if (first->prev != nullptr)
+        {
+          first->prev->next = last->next;
+        }
+        else
+        {
+          m_head = last->next;
+        }
+        if (last->next != nullptr)
+        {
+          last->next->prev = first->prev;
+        }
+        else
+        {
+          m_tail = first->prev;
+        }
+      }
+
+      /**
+       * link the chain first to last, both included, before
+       * position, nullptr meaning the end of the list
+       *
+       * @param  : node* - node to link before
+       *         : node* - first node of the chain
+       *         : node* - last node of the chain
+       * @return : none
+       */
+      void
+      link_before (node *position, node *first, node *last) noexcept
+      {
+        node *prev_node = (position != nullptr) ? position->prev : m_tail;
+        first->prev = prev_node;
+        last->next = position;
+        if (prev_node != nullptr)
+        {
+          prev_node->next = first;
+        }
+        else
+        {
+          m_head = first;
+        }
+        if (position != nullptr)
+        {
+          position->prev = last;
+        }
+        else
+        {
+          m_tail = last;
+        }
+      }
+
+      /**
+       * merge two sorted runs chained on next. Ties are
+       * taken from first so the merge is stable, prev links
+       * are left for the caller. Should comp throw, first
+       * still holds every node of both runs, unsorted
+       *
+       * @param  : node*& - run of the earlier elements, gets
+       *           the merged run
+       *         : node*& - run of the later elements, left
+       *           empty
+       *         : Compare - strict weak ordering on T
+       * @return : none
+       */
+      template<class Compare>
+        static void
+        merge_runs (node *&first, node *&second, Compare &comp)
+        {
+          node *head = nullptr;
+          node **link = &head;
+          try
+          {
+            while (first != nullptr && second != nullptr)
+            {
+              if (comp (second->data, first->data))
+              {
+                *link = second;
+                link = &second->next;
+                second = second->next;
+              }
+              else
+              {
+                *link = first;
+                link = &first->next;
+                first = first->next;
+              }
+            }
+          }
+          catch (...)
+          {
+            link = append_run (link, first);
+            *link = second;
+            first = head;
+            second = nullptr;
+            throw;
+          }
+          *link = (first != nullptr) ? first : second;
+          first = head;
+          second = nullptr;
+        }
+
+      /**
+       * link a run chained on next at link
+       *
+       * @param  : node** - where the run goes
+       *         : node* - the run, may be empty
+       * @return : node** - next link of the run's last node
+       */
+      static node**
+      append_run (node **link, node *run) noexcept
+      {
+        *link = run;
+        for (; *link != nullptr; link = &(*link)->next)
+          ;
+        return link;
+      }
+
+      /**
+       * make the chain on next this list's nodes again,
+       * setting every prev link and m_tail
+       *
+       * @param  : node* - first node of the chain
+       * @return : none
+       */
+      void
+      relink (node *head) noexcept
+      {
+        node *prev_node = nullptr;
+        m_head = head;
+        for (node *cur_node = head; cur_node != nullptr;
+            cur_node = cur_node->next)
+        {
+          cur_node->prev = prev_node;
+          prev_node = cur_node;
+        }
+        m_tail = prev_node;
+      }
+
+      /**
+       * destroy every element without returning the nodes
+       * to the pool, the caller releases or hands over the
+       * slabs afterwards. Nodes of a shared pool are given
+       * back one by one
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      destroy_nodes () noexcept
+      {
+        if (m_pool.shared ())
+        {
+          /* the slabs belong to the group, every node has to
+           go back to it */
+          for (node *cur_node = m_head; cur_node != nullptr;)
+          {
+            node *next_node = cur_node->next;
+            destroy_node (cur_node);
+            cur_node = next_node;
+          }
+        }
+        else if (!std::is_trivially_destructible<T>::value)
+        {
+          allocator_type alloc (get_allocator ());
+          for (node *cur_node = m_head; cur_node != nullptr;)
+          {
+            node *next_node = cur_node->next;
+            alloc_traits::destroy (alloc, std::addressof (cur_node->data));
+            cur_node = next_node;
+          }
+        }
+        m_head = m_tail = nullptr;
+        m_size = 0;
+      }
+
+      /* only allocators that ask for it follow a copy
+       assignment, and the old slabs have to go back to the
+       old allocator first unless the two are interchangeable */
+      void
+      copy_allocator (const list &x, std::true_type)
+      {
+        if (get_allocator () != x.get_allocator ())
+        {
+          clear ();
+        }
+        m_pool.set_allocator (x.m_pool.get_allocator ());
+      }
+
+      void
+      copy_allocator (const list&, std::false_type)
+      {
+      }
+
       void
       push_front_helper (node *cur_node)
       {
@@ -1038,29 +1868,39 @@ namespace miniSTL
         m_size++;
       }
 
-      /* list node type */
+      /* list node type, data is constructed and destroyed
+       separately through the allocator */
       struct node
       {
-        T data;
+        union
+        {
+          T data;
+        };
         struct node *next;
         struct node *prev;
         node () :
-            data (T ()), next (nullptr), prev (nullptr)
+            next (nullptr), prev (nullptr)
         {
         }
-        node (const T &val) :
-            data (T (val)), next (nullptr), prev (nullptr)
-        {
-        }
-        node (T &&val) :
-            data (T (std::move (val))), next (nullptr), prev (nullptr)
+        ~node ()
         {
         }
       };
       node *m_head, *m_tail;
       size_type m_size;
+      node_pool<node, Allocator> m_pool;
     };
 
+#ifdef _LIST_HAVE_PMR_
+  namespace pmr
+  {
+    /* list whose nodes come from a std::pmr::memory_resource,
+     e.g. a monotonic_buffer_resource for request scoped work */
+    template<class T>
+      using list = miniSTL::list<T, std::pmr::polymorphic_allocator<T>>;
+  }
+#endif
+
 }
 
 #endif /* _LIST_HPP_*/
@@ -0,0 +1,968 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _NODE_POOL_HPP_
+#define _NODE_POOL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace miniSTL
+{
+
+  /* fixed size object pool used by the node based containers.
+   Memory is taken from Allocator (rebound to the slot type) in
+   slabs which start small and double up to MaxSlabBytes, so a
+   short list does not pay for a big slab while a long one needs
+   only a handful of allocations. Fresh slots are carved off the
+   newest slab with a bump pointer, returned slots go on an
+   intrusive free list and are handed out first. The pool never
+   walks individual objects to free its slabs, release () or the
+   destructor gives them all back at once. A pool which grew on
+   its own keeps the slabs of its busiest moment, like a vector
+   keeps its capacity. Slabs taken over from other pools may hold
+   far more free slots than that, so once the free list outgrows
+   the most objects the pool ever had live (and a large slab's
+   worth), it is sorted by address and slabs with no live object
+   left are returned early.
+
+   Containers that move nodes between each other (list::splice)
+   call absorb () when the other container gave up all its nodes,
+   which moves its slabs, free list and unused slots over, or
+   share () otherwise. Shared pools form a group, and from then
+   on allocate from the slabs and free list of the group under
+   the group's own lock, so members may live on different
+   threads. A member that leaves must have given back every slot
+   it used, the last one to leave frees the slabs of the group.
+   A pool that finds itself the only member left, directly or
+   through groups that were merged away, takes the group's slabs
+   back and stops locking.
+   */
+  template<class T, class Allocator = std::allocator<T>,
+      size_t MaxSlabBytes = 64 * 1024>
+    class node_pool
+    {
+      union slot;
+      typedef std::allocator_traits<Allocator> alloc_traits;
+    public:
+      typedef T value_type;
+      typedef size_t size_type;
+      typedef typename alloc_traits::template rebind_alloc<slot> allocator_type;
+
+      /**
+       * constructor, no memory is taken until the first
+       * allocate
+       *
+       * @param  : const allocator_type& - allocator the slabs
+       *           are taken from
+       * @return : none
+       */
+      explicit
+      node_pool (const allocator_type &alloc = allocator_type ()) noexcept :
+          m_alloc (alloc), m_store (), m_group (nullptr)
+      {
+      }
+
+      /**
+       * move constructor, the slabs and the allocator are
+       * taken over from x which is left empty
+       *
+       * @param  : node_pool&& - pool to take the slabs from
+       * @return : none
+       */
+      node_pool (node_pool &&x) noexcept :
+          m_alloc (std::move (x.m_alloc)), m_store (x.m_store),
+          m_group (x.m_group)
+      {
+        x.forget ();
+      }
+
+      node_pool (const node_pool&) = delete;
+      node_pool&
+      operator= (const node_pool&) = delete;
+
+      /**
+       * Destructor, every slab is returned to the allocator.
+       * Objects still living in the pool are not destroyed,
+       * the owner has to do that before the pool goes away
+       *
+       * @param  : none
+       * @return : none
+       */
+      ~node_pool ()
+      {
+        release ();
+      }
+
+      /**
+       * get uninitialized storage for one T
+       *
+       * @param  : none
+       * @return : T* - storage suitably sized and aligned
+       *           for a T, throws whatever the allocator
+       *           throws on failure
+       */
+      T*
+      allocate ()
+      {
+        if (m_group != nullptr)
+        {
+          return shared_allocate ();
+        }
+        return reinterpret_cast<T*> (take (m_alloc, m_store));
+      }
+
+      /**
+       * give storage back to the pool. The T living there
+       * must already be destroyed
+       *
+       * @param  : T* - storage obtained from allocate ()
+       * @return : none
+       */
+      void
+      deallocate (T *p) noexcept
+      {
+        slot *s = reinterpret_cast<slot*> (p);
+        if (m_group != nullptr)
+        {
+          std::unique_lock<std::mutex> lock;
+          group *g = lock_root (m_group, lock);
+          give (g->alloc, g->stock, s);
+          if (alone (g))
+          {
+            reclaim (g, lock);
+          }
+          return;
+        }
+        give (m_alloc, m_store, s);
+      }
+
+      /**
+       * return every slab to the allocator in one sweep.
+       * Any storage handed out earlier becomes invalid. A
+       * pool in a group leaves it instead, it has to give
+       * back every slot it used first since the slabs stay
+       * with the group until the last member has left
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      release () noexcept
+      {
+        if (m_group != nullptr)
+        {
+          drop (m_group);
+        }
+        else
+        {
+          free_slabs (m_alloc, m_store.slabs);
+        }
+        forget ();
+      }
+
+      /**
+       * take over all slabs of x, which must hold no live
+       * objects any more, after every object of x has been
+       * moved over to this pool's owner. The slots x had
+       * free or never handed out are kept for reuse, so they
+       * are trimmed like our own. Pools already in a group
+       * share instead
+       *
+       * @param  : node_pool & - the emptied pool
+       * @return : none
+       */
+      void
+      absorb (node_pool &x)
+      {
+        if (this == &x)
+        {
+          return;
+        }
+        if (m_group != nullptr || x.m_group != nullptr)
+        {
+          share (x);
+          return;
+        }
+        merge_stores (m_store, x.m_store);
+        x.forget ();
+      }
+
+      /**
+       * let this pool and x hold objects from each other's
+       * slabs. Both end up in one group whose slabs, free
+       * list and unused slots are those of all its members.
+       * The two allocators must compare equal
+       *
+       * @param  : node_pool & - pool to share slabs with
+       * @return : none
+       */
+      void
+      share (node_pool &x)
+      {
+        if (this == &x)
+        {
+          return;
+        }
+        if (m_group == nullptr && x.m_group == nullptr)
+        {
+          /* nobody else can see a new group yet */
+          group *g = make_group ();
+          join (g);
+          x.join (g);
+          return;
+        }
+        for (;;)
+        {
+          group *mine = root (m_group), *theirs = root (x.m_group);
+          if (mine == theirs)
+          {
+            return;
+          }
+          if (mine == nullptr || theirs == nullptr)
+          {
+            std::unique_lock<std::mutex> lock;
+            group *g = lock_root ((mine != nullptr) ? mine : theirs, lock);
+            join (g);
+            x.join (g);
+            return;
+          }
+          std::unique_lock<std::mutex> lock_mine (mine->lock, std::defer_lock);
+          std::unique_lock<std::mutex> lock_theirs (theirs->lock,
+                                                    std::defer_lock);
+          std::lock (lock_mine, lock_theirs);
+          /* either one may have been merged away meanwhile */
+          if (mine->forward.load (std::memory_order_relaxed) == nullptr
+              && theirs->forward.load (std::memory_order_relaxed) == nullptr)
+          {
+            /* two groups meet, theirs forwards to ours */
+            merge_stores (mine->stock, theirs->stock);
+            mine->refs++;
+            theirs->forward.store (mine, std::memory_order_release);
+            return;
+          }
+        }
+      }
+
+      /**
+       * drop our own slabs and take over the slabs of x.
+       * The allocator follows only when the allocator asks
+       * to be propagated on move assignment, so the caller
+       * has to make sure the two allocators compare equal
+       * otherwise
+       *
+       * @param  : node_pool & - pool to take the slabs from
+       * @return : none
+       */
+      void
+      adopt (node_pool &x) noexcept
+      {
+        release ();
+        move_allocator (x,
+            typename slot_traits::propagate_on_container_move_assignment ());
+        m_store = x.m_store;
+        m_group = x.m_group;
+        x.forget ();
+      }
+
+      /**
+       * swaps the slabs and free list with another pool.
+       * Allocators are swapped only when they ask to be
+       * propagated on swap
+       *
+       * @param  : node_pool & - the pool to swap with
+       * @return : none
+       */
+      void
+      swap (node_pool &x) noexcept
+      {
+        swap_allocator (x,
+            typename slot_traits::propagate_on_container_swap ());
+        std::swap (m_store, x.m_store);
+        std::swap (m_group, x.m_group);
+      }
+
+      /**
+       * replace the allocator, only valid while the pool
+       * holds no slabs
+       *
+       * @param  : const allocator_type& - the new allocator
+       * @return : none
+       */
+      void
+      set_allocator (const allocator_type &alloc)
+      {
+        m_alloc = alloc;
+      }
+
+      /**
+       * returns the allocator the slabs come from
+       *
+       * @param  : none
+       * @return : allocator_type - copy of the allocator
+       */
+      allocator_type
+      get_allocator () const noexcept
+      {
+        return m_alloc;
+      }
+
+      /**
+       * number of slabs currently held from the allocator,
+       * slabs held by a group are not counted
+       *
+       * @param  : none
+       * @return : size_type - slab count
+       */
+      size_type
+      slab_count () const noexcept
+      {
+        return m_store.slab_count;
+      }
+
+      /**
+       * tells whether the pool is in a group. Owners of a
+       * shared pool have to deallocate every object before
+       * release (), the slabs are not theirs to free
+       *
+       * @param  : none
+       * @return : bool - true once share () was called
+       */
+      bool
+      shared () const noexcept
+      {
+        return m_group != nullptr;
+      }
+
+    private:
+
+      /* a slot either holds a live T or links the free list */
+      union slot
+      {
+        slot *next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+      };
+
+      /* slab header, kept in the first slots of each slab. idle
+       is only used while trimming */
+      struct slab
+      {
+        slab *next;
+        size_type count;
+        size_type idle;
+      };
+
+      /* everything a pool hands out from. The tails are only
+       valid while their list is not empty, they let absorb ()
+       and share () chain lists in constant time */
+      struct store
+      {
+        store () :
+            free (nullptr), free_tail (nullptr), free_count (0),
+            slabs (nullptr), slabs_tail (nullptr), cursor (nullptr),
+            limit (nullptr), next_count (FIRST_SLAB), slab_count (0),
+            capacity (0), peak (0), trim_at (TRIM_MIN)
+        {
+        }
+        slot *free, *free_tail;
+        size_type free_count;
+        slab *slabs, *slabs_tail;
+        slot *cursor, *limit;
+        size_type next_count;
+        size_type slab_count;
+        /* slots in all slabs, and the most of them live at once */
+        size_type capacity, peak;
+        size_type trim_at;
+
+        size_type
+        live () const noexcept
+        {
+          return capacity - free_count - (limit - cursor);
+        }
+      };
+
+      /* store shared by pools which exchanged objects. A group
+       merged into another one only forwards to it, pools and
+       forwarders each hold one reference on what they point at.
+       lock guards the store and refs of a group which does not
+       forward, a forwarder's refs only ever go down */
+      struct group
+      {
+        group (const allocator_type &alloc) :
+            forward (nullptr), refs (0), stock (), alloc (alloc)
+        {
+        }
+        std::atomic<group*> forward;
+        std::atomic<size_type> refs;
+        store stock;
+        allocator_type alloc;
+        std::mutex lock;
+      };
+
+      typedef std::allocator_traits<allocator_type> slot_traits;
+      typedef typename slot_traits::template rebind_alloc<group> group_allocator;
+      typedef std::allocator_traits<group_allocator> group_traits;
+
+      /* a list of one costs one slot plus a header, like a
+       node on its own would */
+      static const size_type FIRST_SLAB = 1;
+      static const size_type HEADER_SLOTS = (sizeof(slab) + sizeof(slot) - 1)
+          / sizeof(slot);
+      static const size_type MAX_SLAB = MaxSlabBytes / sizeof(slot)
+          > HEADER_SLOTS + FIRST_SLAB ?
+          MaxSlabBytes / sizeof(slot) - HEADER_SLOTS : FIRST_SLAB;
+      /* free slots below this are never worth a trim */
+      static const size_type TRIM_MIN = MAX_SLAB;
+
+      /**
+       * hand out one slot of a store, from the free list
+       * first, then from the bump cursor
+       *
+       * @param  : allocator_type& - allocator for a new slab
+       *         : store & - store to take the slot from
+       * @return : slot* - the slot
+       */
+      static slot*
+      take (allocator_type &alloc, store &st)
+      {
+        if (st.free != nullptr)
+        {
+          slot *s = st.free;
+          st.free = s->next;
+          st.free_count--;
+          return s;
+        }
+        if (st.cursor == st.limit)
+        {
+          grow (alloc, st);
+        }
+        return st.cursor++;
+      }
+
+      /**
+       * put one slot on the free list of a store, trimming
+       * it once the free list holds more than the store ever
+       * had live
+       *
+       * @param  : allocator_type& - allocator of the slabs
+       *         : store & - store the slot belongs to
+       *         : slot* - the slot
+       * @return : none
+       */
+      static void
+      give (allocator_type &alloc, store &st, slot *s) noexcept
+      {
+        if (st.free == nullptr)
+        {
+          st.free_tail = s;
+        }
+        s->next = st.free;
+        st.free = s;
+        if (++st.free_count > st.trim_at && st.free_count > st.peak)
+        {
+          trim (alloc, st);
+        }
+      }
+
+      /**
+       * take a new slab from the allocator and point the
+       * bump cursor at it. Slab size doubles until MAX_SLAB
+       *
+       * @param  : allocator_type& - allocator to take it from
+       *         : store & - store to add the slab to
+       * @return : none
+       */
+      static void
+      grow (allocator_type &alloc, store &st)
+      {
+        size_type count = st.next_count;
+        slot *block = slot_traits::allocate (alloc, HEADER_SLOTS + count);
+        slab *s = reinterpret_cast<slab*> (block);
+        s->next = st.slabs;
+        s->count = count;
+        if (st.slabs == nullptr)
+        {
+          st.slabs_tail = s;
+        }
+        st.slabs = s;
+        st.cursor = block + HEADER_SLOTS;
+        st.limit = st.cursor + count;
+        st.next_count = (count * 2 < MAX_SLAB) ? count * 2 : MAX_SLAB;
+        st.slab_count++;
+        /* every other slot is in use when we have to grow */
+        st.capacity += count;
+        st.peak = st.capacity;
+      }
+
+      /**
+       * move everything of the store from into the store to.
+       * The unused slots of the smaller bump region go on
+       * the free list, at most one slab's worth
+       *
+       * @param  : store & - store to merge into
+       *         : store & - store to empty
+       * @return : none
+       */
+      static void
+      merge_stores (store &to, store &from) noexcept
+      {
+        size_type live = to.live () + from.live ();
+        if (from.slabs != nullptr)
+        {
+          from.slabs_tail->next = to.slabs;
+          if (to.slabs == nullptr)
+          {
+            to.slabs_tail = from.slabs_tail;
+          }
+          to.slabs = from.slabs;
+          to.slab_count += from.slab_count;
+        }
+        if (from.free != nullptr)
+        {
+          from.free_tail->next = to.free;
+          if (to.free == nullptr)
+          {
+            to.free_tail = from.free_tail;
+          }
+          to.free = from.free;
+          to.free_count += from.free_count;
+        }
+        if (from.limit - from.cursor > to.limit - to.cursor)
+        {
+          std::swap (to.cursor, from.cursor);
+          std::swap (to.limit, from.limit);
+        }
+        for (; from.cursor != from.limit; from.cursor++)
+        {
+          if (to.free == nullptr)
+          {
+            to.free_tail = from.cursor;
+          }
+          from.cursor->next = to.free;
+          to.free = from.cursor;
+          to.free_count++;
+        }
+        if (from.next_count > to.next_count)
+        {
+          to.next_count = from.next_count;
+        }
+        to.capacity += from.capacity;
+        if (live > to.peak)
+        {
+          to.peak = live;
+        }
+        from = store ();
+      }
+
+      static bool
+      before (const void *a, const void *b) noexcept
+      {
+        return std::less<const void*> () (a, b);
+      }
+
+      /**
+       * merge two chains sorted by address
+       *
+       * @param  : Link* - first chain
+       *         : Link* - second chain
+       * @return : Link* - head of the merged chain
+       */
+      template<class Link>
+        static Link*
+        merge_chains (Link *first, Link *second) noexcept
+        {
+          Link *head = nullptr;
+          Link **link = &head;
+          while (first != nullptr && second != nullptr)
+          {
+            if (before (second, first))
+            {
+              *link = second;
+              second = second->next;
+            }
+            else
+            {
+              *link = first;
+              first = first->next;
+            }
+            link = &(*link)->next;
+          }
+          *link = (first != nullptr) ? first : second;
+          return head;
+        }
+
+      /**
+       * sort a chain linked through next by address, bottom
+       * up the same way list::sort does, without allocating
+       *
+       * @param  : Link* - head of the chain
+       * @return : Link* - head of the sorted chain
+       */
+      template<class Link>
+        static Link*
+        sort_chain (Link *head) noexcept
+        {
+          Link *bins[64] =
+            { };
+          size_type used = 0;
+          while (head != nullptr)
+          {
+            Link *run = head;
+            head = head->next;
+            run->next = nullptr;
+            size_type i = 0;
+            for (; i < used && bins[i] != nullptr; i++)
+            {
+              run = merge_chains (bins[i], run);
+              bins[i] = nullptr;
+            }
+            if (i == used)
+            {
+              used++;
+            }
+            bins[i] = run;
+          }
+          Link *sorted = nullptr;
+          for (size_type i = 0; i < used; i++)
+          {
+            if (bins[i] != nullptr)
+            {
+              sorted = merge_chains (bins[i], sorted);
+            }
+          }
+          return sorted;
+        }
+
+      /**
+       * return every slab of a store which holds no live
+       * object to the allocator. The free list and the slabs
+       * are sorted by address so one pass counts the free
+       * slots of each slab, a second one unlinks the slots of
+       * the idle slabs. Costs O(f log f) for f free slots, and
+       * the free list has to double before the next run, so
+       * it is amortized over the deallocations
+       *
+       * @param  : allocator_type& - allocator of the slabs
+       *         : store & - store to trim
+       * @return : none
+       */
+      static void
+      trim (allocator_type &alloc, store &st) noexcept
+      {
+        st.free = sort_chain (st.free);
+        st.slabs = sort_chain (st.slabs);
+
+        slot *f = st.free;
+        for (slab *s = st.slabs; s != nullptr; s = s->next)
+        {
+          slot *first = reinterpret_cast<slot*> (s) + HEADER_SLOTS;
+          slot *last = first + s->count;
+          s->idle = 0;
+          for (; f != nullptr && before (f, last); f = f->next)
+          {
+            s->idle++;
+          }
+          if (st.cursor != nullptr && !before (st.cursor, first)
+              && !before (last, st.cursor))
+          {
+            s->idle += st.limit - st.cursor;
+          }
+        }
+
+        f = st.free;
+        slot **link = &st.free;
+        slab **slab_link = &st.slabs;
+        st.free_tail = nullptr;
+        st.slabs_tail = nullptr;
+        for (slab *s = st.slabs; s != nullptr;)
+        {
+          slab *next_slab = s->next;
+          slot *first = reinterpret_cast<slot*> (s) + HEADER_SLOTS;
+          slot *last = first + s->count;
+          bool idle = s->idle == s->count;
+          while (f != nullptr && before (f, last))
+          {
+            slot *next_slot = f->next;
+            if (idle)
+            {
+              st.free_count--;
+            }
+            else
+            {
+              *link = f;
+              link = &f->next;
+              st.free_tail = f;
+            }
+            f = next_slot;
+          }
+          if (idle)
+          {
+            if (st.cursor != nullptr && !before (st.cursor, first)
+                && !before (last, st.cursor))
+            {
+              st.cursor = st.limit = nullptr;
+            }
+            st.slab_count--;
+            st.capacity -= s->count;
+            slot_traits::deallocate (alloc, reinterpret_cast<slot*> (s),
+                                     HEADER_SLOTS + s->count);
+          }
+          else
+          {
+            *slab_link = s;
+            slab_link = &s->next;
+            st.slabs_tail = s;
+          }
+          s = next_slab;
+        }
+        *link = nullptr;
+        *slab_link = nullptr;
+        st.trim_at =
+            (st.free_count * 2 > TRIM_MIN) ? st.free_count * 2 : TRIM_MIN;
+      }
+
+      /**
+       * allocate from the group. A pool left alone in its
+       * group takes the group's store back first, so it
+       * stops paying for the lock
+       *
+       * @param  : none
+       * @return : T* - storage for a T
+       */
+      T*
+      shared_allocate ()
+      {
+        std::unique_lock<std::mutex> lock;
+        group *g = lock_root (m_group, lock);
+        if (alone (g))
+        {
+          reclaim (g, lock);
+          return reinterpret_cast<T*> (take (m_alloc, m_store));
+        }
+        return reinterpret_cast<T*> (take (g->alloc, g->stock));
+      }
+
+      /**
+       * tells whether no other pool reaches the group g,
+       * called with g locked. Every group from ours to g may
+       * only be referenced by the one before it
+       *
+       * @param  : group* - root of our group, locked
+       * @return : bool - true when we are the only member
+       */
+      bool
+      alone (group *g) const noexcept
+      {
+        for (group *h = m_group; h != g;
+            h = h->forward.load (std::memory_order_acquire))
+        {
+          if (h->refs.load (std::memory_order_relaxed) != 1)
+          {
+            return false;
+          }
+        }
+        return g->refs.load (std::memory_order_relaxed) == 1;
+      }
+
+      /**
+       * take the store of a group only we are left in and
+       * leave it, which frees the group and its forwarders
+       *
+       * @param  : group* - root of our group
+       *         : std::unique_lock & - its lock, released here
+       * @return : none
+       */
+      void
+      reclaim (group *g, std::unique_lock<std::mutex> &lock) noexcept
+      {
+        m_store = g->stock;
+        g->stock = store ();
+        lock.unlock ();
+        drop (m_group);
+        m_group = nullptr;
+      }
+
+      /* allocators which do not propagate may not even be
+       assignable (std::pmr::polymorphic_allocator), so these
+       are picked by tag instead of a runtime branch */
+      void
+      move_allocator (node_pool &x, std::true_type) noexcept
+      {
+        m_alloc = std::move (x.m_alloc);
+      }
+
+      void
+      move_allocator (node_pool&, std::false_type) noexcept
+      {
+      }
+
+      void
+      swap_allocator (node_pool &x, std::true_type) noexcept
+      {
+        std::swap (m_alloc, x.m_alloc);
+      }
+
+      void
+      swap_allocator (node_pool&, std::false_type) noexcept
+      {
+      }
+
+      static group*
+      root (group *g) noexcept
+      {
+        group *next;
+        while (g != nullptr
+            && (next = g->forward.load (std::memory_order_acquire)) != nullptr)
+        {
+          g = next;
+        }
+        return g;
+      }
+
+      /**
+       * lock the group at the end of the forwarding chain of
+       * g. The group may start to forward while we wait for
+       * its lock, then the chain is followed on
+       *
+       * @param  : group* - a group of ours
+       *         : std::unique_lock & - gets the lock
+       * @return : group* - the locked root
+       */
+      static group*
+      lock_root (group *g, std::unique_lock<std::mutex> &lock) noexcept
+      {
+        for (;;)
+        {
+          g = root (g);
+          std::unique_lock<std::mutex> candidate (g->lock);
+          if (g->forward.load (std::memory_order_relaxed) == nullptr)
+          {
+            lock = std::move (candidate);
+            return g;
+          }
+        }
+      }
+
+      /**
+       * return a chain of slabs to the allocator
+       *
+       * @param  : allocator_type& - allocator of the slabs
+       *         : slab* - first slab of the chain
+       * @return : none
+       */
+      static void
+      free_slabs (allocator_type &alloc, slab *s) noexcept
+      {
+        while (s != nullptr)
+        {
+          slab *next = s->next;
+          slot_traits::deallocate (alloc, reinterpret_cast<slot*> (s),
+                                   HEADER_SLOTS + s->count);
+          s = next;
+        }
+      }
+
+      group*
+      make_group ()
+      {
+        group_allocator alloc (m_alloc);
+        group *g = group_traits::allocate (alloc, 1);
+        ::new (g) group (m_alloc);
+        return g;
+      }
+
+      /* called with the group locked or not seen by anyone
+       else yet, our store goes to the group */
+      void
+      join (group *g) noexcept
+      {
+        if (m_group == nullptr)
+        {
+          merge_stores (g->stock, m_store);
+          m_group = g;
+          g->refs++;
+        }
+      }
+
+      /**
+       * drop one reference on a group. A group nobody points
+       * at any more frees its slabs, or drops its own
+       * reference when it forwards
+       *
+       * @param  : group* - group to release
+       * @return : none
+       */
+      static void
+      drop (group *g) noexcept
+      {
+        while (g != nullptr)
+        {
+          group *next;
+          {
+            std::lock_guard<std::mutex> lock (g->lock);
+            if (--g->refs != 0)
+            {
+              return;
+            }
+            next = g->forward.load (std::memory_order_relaxed);
+          }
+          /* nobody can reach g any more */
+          free_slabs (g->alloc, g->stock.slabs);
+          group_allocator alloc (g->alloc);
+          g->~group ();
+          group_traits::deallocate (alloc, g, 1);
+          g = next;
+        }
+      }
+
+      /**
+       * reset to the empty state without touching the slabs,
+       * used once they have been freed or handed over
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      forget () noexcept
+      {
+        m_store = store ();
+        m_group = nullptr;
+      }
+
+      allocator_type m_alloc;
+      store m_store;
+      group *m_group;
+    };
+
+}
+
+#endif /* _NODE_POOL_HPP_*/
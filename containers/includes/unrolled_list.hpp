@@ -0,0 +1,930 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _UNROLLED_LIST_HPP_
+#define _UNROLLED_LIST_HPP_
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "node_pool.hpp"
+
+namespace miniSTL
+{
+
+  /* number of elements packed into one unrolled_list node. The
+   node is sized to about two cache lines, two pointers and a
+   count included, but never holds fewer than 8 or more than 64
+   elements */
+  template<class T>
+    struct unrolled_capacity
+    {
+      static const size_t bytes = 128 - 2 * sizeof(void*) - sizeof(size_t);
+      static const size_t value =
+          bytes / sizeof(T) < 8 ? 8 :
+          bytes / sizeof(T) > 64 ? 64 : bytes / sizeof(T);
+    };
+
+  /* doubly linked list of small arrays. Each node keeps up to
+   Capacity elements packed at its front, so walking the list
+   touches one node per Capacity elements instead of one per
+   element, and the link overhead is shared as well.
+
+   A full node is split in two halves on insert. After an erase a
+   node is merged with a neighbour once both together are at most
+   half full, which keeps nodes at least a quarter full on average.
+   Inserting or erasing moves elements inside the node involved
+   (and the neighbour it is split from or merged with), so only
+   iterators and references into those nodes are invalidated.
+   Iterators into every other node stay valid.
+   */
+  template<class T, size_t Capacity = unrolled_capacity<T>::value>
+    class unrolled_list
+    {
+      static_assert (Capacity >= 2,
+          "unrolled_list needs room for two elements per node");
+
+      struct node;
+    public:
+
+      /* iterator and const_iterator, the node pointer stays
+       mutable so a const_iterator can still be stepped */
+      template<bool Const>
+        struct basic_iterator
+        {
+          basic_iterator () :
+              iter_node (nullptr), index (0)
+          {
+          }
+          basic_iterator (node *val, size_t pos) :
+              iter_node (val), index (pos)
+          {
+          }
+
+          /* an iterator converts to a const_iterator */
+          template<bool Other, typename = typename std::enable_if<
+              Const && !Other>::type>
+            basic_iterator (const basic_iterator<Other> &iter) :
+                iter_node (iter.iter_node), index (iter.index)
+            {
+            }
+
+          friend class unrolled_list;
+          template<bool Other>
+            friend struct basic_iterator;
+          using iterator_category = std::bidirectional_iterator_tag;
+          using difference_type = std::ptrdiff_t;
+          using value_type = T;
+          using pointer = typename std::conditional<Const, const T*, T*>::type;
+          using reference = typename std::conditional<Const, const T&, T&>::type;
+
+          /* postfix */
+          basic_iterator
+          operator++ (int)
+          {
+            basic_iterator previous = *this;
+            ++*this;
+            return previous;
+          }
+
+          /* prefix, the past the end position of the last node
+           is end (), for the others we step to the next node */
+          basic_iterator&
+          operator++ ()
+          {
+            if (++index == iter_node->count && iter_node->next != nullptr)
+            {
+              iter_node = iter_node->next;
+              index = 0;
+            }
+            return *this;
+          }
+
+          /* postfix */
+          basic_iterator
+          operator-- (int)
+          {
+            basic_iterator previous = *this;
+            --*this;
+            return previous;
+          }
+
+          /* prefix */
+          basic_iterator&
+          operator-- ()
+          {
+            if (index == 0)
+            {
+              iter_node = iter_node->prev;
+              index = iter_node->count;
+            }
+            index--;
+            return *this;
+          }
+
+          template<bool Other>
+            bool
+            operator!= (const basic_iterator<Other> &iter) const
+            {
+              return iter_node != iter.iter_node || index != iter.index;
+            }
+
+          template<bool Other>
+            bool
+            operator== (const basic_iterator<Other> &iter) const
+            {
+              return iter_node == iter.iter_node && index == iter.index;
+            }
+
+          reference
+          operator* () const
+          {
+            return *iter_node->at (index);
+          }
+
+          pointer
+          operator-> () const
+          {
+            return iter_node->at (index);
+          }
+
+        private:
+          node *iter_node;
+          size_t index;
+        };
+
+      typedef basic_iterator<false> iterator;
+      typedef basic_iterator<true> const_iterator;
+      typedef T value_type;
+      typedef value_type *pointer;
+      typedef const value_type *const_pointer;
+      typedef value_type &reference;
+      typedef const value_type &const_reference;
+      typedef size_t size_type;
+
+      template<typename InputIterator>
+        using RequireInputIterator = typename
+        std::enable_if<std::is_convertible<typename
+        std::iterator_traits<InputIterator>::iterator_category,
+        std::input_iterator_tag>::value>::type;
+
+      /// constructors ///
+
+      /**
+       * default constructor for an unrolled list
+       *
+       * @param  : none
+       * @return : none
+       */
+      unrolled_list () :
+          m_head (nullptr), m_tail (nullptr), m_size (0), m_nodes (0)
+      {
+      }
+
+      /**
+       * fill constructor, n copies of val
+       *
+       * @param  : size_type - number of elements
+       *         : const value_type& - value of each element
+       * @return : none
+       */
+      explicit
+      unrolled_list (size_type n, const value_type &val = value_type ()) :
+          unrolled_list ()
+      {
+        while (n--)
+        {
+          push_back (val);
+        }
+      }
+
+      /**
+       * range constructor
+       *
+       * @param  : InputIterator - start of the range
+       *         : InputIterator - end of the range
+       * @return : none
+       */
+      template<class InputIterator, typename = RequireInputIterator<
+          InputIterator>>
+        unrolled_list (InputIterator first, InputIterator last) :
+            unrolled_list ()
+        {
+          for (; first != last; ++first)
+          {
+            push_back (*first);
+          }
+        }
+
+      /**
+       * initializer list constructor
+       *
+       * @param  : std::initializer_list<value_type> - values
+       *           to copy into the list
+       * @return : none
+       */
+      unrolled_list (std::initializer_list<value_type> il) :
+          unrolled_list (il.begin (), il.end ())
+      {
+      }
+
+      /**
+       * copy constructor, the copy is packed into full nodes
+       * whatever the fill of x
+       *
+       * @param  : const unrolled_list& - list to copy
+       * @return : none
+       */
+      unrolled_list (const unrolled_list &x) :
+          unrolled_list (x.begin (), x.end ())
+      {
+      }
+
+      /**
+       * move constructor, nodes are taken over from x
+       *
+       * @param  : unrolled_list&& - list to move from
+       * @return : none
+       */
+      unrolled_list (unrolled_list &&x) noexcept :
+          m_head (x.m_head), m_tail (x.m_tail), m_size (x.m_size), m_nodes (
+              x.m_nodes), m_pool (std::move (x.m_pool))
+      {
+        x.m_head = x.m_tail = nullptr;
+        x.m_size = x.m_nodes = 0;
+      }
+
+      /// destructor ///
+
+      /**
+       * Destructor
+       *
+       * @param  : none
+       * @return : none
+       */
+      ~unrolled_list ()
+      {
+        destroy_elements ();
+      }
+
+      /// assignment operator ///
+
+      /**
+       * copy assignment operator
+       *
+       * @param  : const unrolled_list& - list to copy
+       * @return : reference to this list
+       */
+      unrolled_list&
+      operator= (const unrolled_list &x)
+      {
+        if (this != &x)
+        {
+          clear ();
+          for (auto &el : x)
+          {
+            push_back (el);
+          }
+        }
+        return *this;
+      }
+
+      /**
+       * move assignment operator
+       *
+       * @param  : unrolled_list&& - list to move from
+       * @return : reference to this list
+       */
+      unrolled_list&
+      operator= (unrolled_list &&x) noexcept
+      {
+        if (this != &x)
+        {
+          destroy_elements ();
+          m_pool.adopt (x.m_pool);
+          m_head = x.m_head;
+          m_tail = x.m_tail;
+          m_size = x.m_size;
+          m_nodes = x.m_nodes;
+          x.m_head = x.m_tail = nullptr;
+          x.m_size = x.m_nodes = 0;
+        }
+        return *this;
+      }
+
+      /**
+       * initializer list assignment operator
+       *
+       * @param  : std::initializer_list<value_type> - values
+       *           to copy into the list
+       * @return : reference to this list
+       */
+      unrolled_list&
+      operator= (std::initializer_list<value_type> il)
+      {
+        clear ();
+        for (auto &el : il)
+        {
+          push_back (el);
+        }
+        return *this;
+      }
+
+      /// Element access ///
+
+      /**
+       * get the first element, undefined on an empty list
+       *
+       * @param  : none
+       * @return : reference to first element
+       */
+      reference
+      front ()
+      {
+        return *m_head->at (0);
+      }
+
+      const_reference
+      front () const
+      {
+        return *m_head->at (0);
+      }
+
+      /**
+       * get the last element, undefined on an empty list
+       *
+       * @param  : none
+       * @return : reference to last element
+       */
+      reference
+      back ()
+      {
+        return *m_tail->at (m_tail->count - 1);
+      }
+
+      const_reference
+      back () const
+      {
+        return *m_tail->at (m_tail->count - 1);
+      }
+
+      /// Modifiers ///
+
+      /**
+       * push an element to the back of the list. A full
+       * tail is not split, a new node is started instead
+       * so appending fills every node completely
+       *
+       * @param  : value_type& - value to be pushed
+       * @return : none
+       */
+      void
+      push_back (const value_type &val)
+      {
+        emplace_back (val);
+      }
+
+      void
+      push_back (value_type &&val)
+      {
+        emplace_back (std::move (val));
+      }
+
+      /**
+       * construct an element in place at the back
+       *
+       * @param  : Args&& - constructor arguments of T
+       * @return : none
+       */
+      template<class ... Args>
+        void
+        emplace_back (Args &&... args)
+        {
+          if (m_tail == nullptr || m_tail->count == Capacity)
+          {
+            /* construct first, args may refer into the list */
+            node *n = create_node ();
+            try
+            {
+              ::new (n->at (0)) T (std::forward<Args> (args)...);
+            }
+            catch (...)
+            {
+              m_pool.deallocate (n);
+              throw;
+            }
+            link_after (m_tail, n);
+            n->count = 1;
+          }
+          else
+          {
+            ::new (m_tail->at (m_tail->count)) T (std::forward<Args> (args)...);
+            m_tail->count++;
+          }
+          m_size++;
+        }
+
+      /**
+       * push an element to the front of the list
+       *
+       * @param  : value_type& - value to be pushed
+       * @return : none
+       */
+      void
+      push_front (const value_type &val)
+      {
+        insert (begin (), val);
+      }
+
+      void
+      push_front (value_type &&val)
+      {
+        insert (begin (), std::move (val));
+      }
+
+      /**
+       * remove the last element
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      pop_back ()
+      {
+        if (!empty ())
+        {
+          erase (iterator (m_tail, m_tail->count - 1));
+        }
+      }
+
+      /**
+       * remove the first element
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      pop_front ()
+      {
+        if (!empty ())
+        {
+          erase (begin ());
+        }
+      }
+
+      /**
+       * insert a single element before the given iterator.
+       * A full node is split in half first
+       *
+       * @param  : const_iterator - position to insert before
+       *         : value_type& - value to be inserted
+       * @return : iterator to the element inserted
+       */
+      iterator
+      insert (const_iterator position, const value_type &val)
+      {
+        return emplace (position, val);
+      }
+
+      iterator
+      insert (const_iterator position, value_type &&val)
+      {
+        return emplace (position, std::move (val));
+      }
+
+      /**
+       * construct an element in place before the given
+       * iterator
+       *
+       * @param  : const_iterator - position to insert before
+       *         : Args&& - constructor arguments of T
+       * @return : iterator to the element inserted
+       */
+      template<class ... Args>
+        iterator
+        emplace (const_iterator position, Args &&... args)
+        {
+          node *n = position.iter_node;
+          size_type i = position.index;
+          if (n == nullptr || (n == m_tail && i == n->count))
+          {
+            emplace_back (std::forward<Args> (args)...);
+            return iterator (m_tail, m_tail->count - 1);
+          }
+
+          /* elements are about to move, args may refer to one */
+          T val (std::forward<Args> (args)...);
+          if (n->count == Capacity)
+          {
+            node *upper = create_node ();
+            link_after (n, upper);
+            move_elements (n, Capacity / 2, Capacity, upper);
+            if (i > n->count)
+            {
+              i -= n->count;
+              n = upper;
+            }
+          }
+
+          if (i == n->count)
+          {
+            ::new (n->at (i)) T (std::move (val));
+          }
+          else
+          {
+            ::new (n->at (n->count)) T (std::move (*n->at (n->count - 1)));
+            for (size_type j = n->count - 1; j > i; j--)
+            {
+              *n->at (j) = std::move (*n->at (j - 1));
+            }
+            *n->at (i) = std::move (val);
+          }
+          n->count++;
+          m_size++;
+          return iterator (n, i);
+        }
+
+      /**
+       * insert a range of elements before the given iterator
+       *
+       * @param  : const_iterator - position to insert before
+       *         : InputIterator - start of the range
+       *         : InputIterator - end of the range
+       * @return : iterator to the first element inserted
+       */
+      template<class InputIterator, typename = RequireInputIterator<
+          InputIterator>>
+        iterator
+        insert (const_iterator position, InputIterator first,
+                InputIterator last)
+        {
+          if (first == last)
+          {
+            return iterator (position.iter_node, position.index);
+          }
+          iterator cur = insert (position, *first++);
+          size_type n = 1;
+          while (first != last)
+          {
+            cur = insert (++cur, *first++);
+            n++;
+          }
+          /* a later split may have moved the first element
+           inserted, so walk back to it from the last one */
+          while (--n)
+          {
+            --cur;
+          }
+          return cur;
+        }
+
+      /**
+       * erase a single element. The node is merged with a
+       * neighbour when the two fit in half a node
+       *
+       * @param  : const_iterator - element to be erased
+       * @return : iterator to the element following the
+       *           erased one
+       */
+      iterator
+      erase (const_iterator position)
+      {
+        node *n = position.iter_node;
+        size_type i = position.index;
+
+        for (size_type j = i; j + 1 < n->count; j++)
+        {
+          *n->at (j) = std::move (*n->at (j + 1));
+        }
+        n->count--;
+        n->at (n->count)->~T ();
+        m_size--;
+
+        if (n->count == 0)
+        {
+          node *next = n->next;
+          unlink (n);
+          return next != nullptr ? iterator (next, 0) : end ();
+        }
+
+        node *next = n->next;
+        if (next != nullptr && n->count + next->count <= Capacity / 2)
+        {
+          move_elements (next, 0, next->count, n);
+          unlink (next);
+        }
+        node *prev = n->prev;
+        if (prev != nullptr && prev->count + n->count <= Capacity / 2)
+        {
+          i += prev->count;
+          move_elements (n, 0, n->count, prev);
+          unlink (n);
+          n = prev;
+        }
+
+        if (i == n->count && n->next != nullptr)
+        {
+          return iterator (n->next, 0);
+        }
+        return iterator (n, i);
+      }
+
+      /**
+       * erase a range of elements
+       *
+       * @param  : const_iterator - first element to erase
+       *         : const_iterator - element after the last
+       *           one to erase
+       * @return : iterator to the element following the
+       *           last erased one
+       */
+      iterator
+      erase (const_iterator first, const_iterator last)
+      {
+        /* merges may move last, so count instead of comparing */
+        size_type n = std::distance (first, last);
+        iterator cur (first.iter_node, first.index);
+        while (n--)
+        {
+          cur = erase (cur);
+        }
+        return cur;
+      }
+
+      /**
+       * removes every element and hands all nodes back
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      clear () noexcept
+      {
+        destroy_elements ();
+        m_pool.release ();
+      }
+
+      /**
+       * swaps the contents with another unrolled list
+       *
+       * @param  : unrolled_list & - the list to swap with
+       * @return : none
+       */
+      void
+      swap (unrolled_list &x) noexcept
+      {
+        std::swap (m_head, x.m_head);
+        std::swap (m_tail, x.m_tail);
+        std::swap (m_size, x.m_size);
+        std::swap (m_nodes, x.m_nodes);
+        m_pool.swap (x.m_pool);
+      }
+
+      /// Capacity ///
+
+      size_type
+      size () const noexcept
+      {
+        return m_size;
+      }
+
+      bool
+      empty () const noexcept
+      {
+        return m_size == 0;
+      }
+
+      /**
+       * number of nodes the elements are spread over
+       *
+       * @param  : none
+       * @return : size_type - node count
+       */
+      size_type
+      node_count () const noexcept
+      {
+        return m_nodes;
+      }
+
+      /// Iterators ///
+
+      iterator
+      begin () noexcept
+      {
+        return iterator (m_head, 0);
+      }
+
+      const_iterator
+      begin () const noexcept
+      {
+        return const_iterator (m_head, 0);
+      }
+
+      const_iterator
+      cbegin () const noexcept
+      {
+        return begin ();
+      }
+
+      /* one past the last element of the tail node, so that
+       decrementing end () reaches back () */
+      iterator
+      end () noexcept
+      {
+        return iterator (m_tail, m_tail != nullptr ? m_tail->count : 0);
+      }
+
+      const_iterator
+      end () const noexcept
+      {
+        return const_iterator (m_tail, m_tail != nullptr ? m_tail->count : 0);
+      }
+
+      const_iterator
+      cend () const noexcept
+      {
+        return end ();
+      }
+
+    private:
+
+      /* node type, count elements live at the front of slots */
+      struct node
+      {
+        node *next;
+        node *prev;
+        size_type count;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[Capacity];
+
+        T*
+        at (size_type i)
+        {
+          return reinterpret_cast<T*> (&slots[i]);
+        }
+      };
+
+      /**
+       * get an empty unlinked node from the pool
+       *
+       * @param  : none
+       * @return : node* - the new node
+       */
+      node*
+      create_node ()
+      {
+        node *n = m_pool.allocate ();
+        n->next = n->prev = nullptr;
+        n->count = 0;
+        return n;
+      }
+
+      /**
+       * link a node after prev, or at the head when prev
+       * is nullptr
+       *
+       * @param  : node* - node to link after
+       *         : node* - node to be linked
+       * @return : none
+       */
+      void
+      link_after (node *prev, node *n) noexcept
+      {
+        node *next = (prev != nullptr) ? prev->next : m_head;
+        n->prev = prev;
+        n->next = next;
+        if (prev != nullptr)
+        {
+          prev->next = n;
+        }
+        else
+        {
+          m_head = n;
+        }
+        if (next != nullptr)
+        {
+          next->prev = n;
+        }
+        else
+        {
+          m_tail = n;
+        }
+        m_nodes++;
+      }
+
+      /**
+       * unlink an empty node and return it to the pool
+       *
+       * @param  : node* - node to be removed
+       * @return : none
+       */
+      void
+      unlink (node *n) noexcept
+      {
+        if (n->prev != nullptr)
+        {
+          n->prev->next = n->next;
+        }
+        else
+        {
+          m_head = n->next;
+        }
+        if (n->next != nullptr)
+        {
+          n->next->prev = n->prev;
+        }
+        else
+        {
+          m_tail = n->prev;
+        }
+        m_pool.deallocate (n);
+        m_nodes--;
+      }
+
+      /**
+       * move the elements [first, last) of src to the end of
+       * dst. Elements after last in src close the gap
+       *
+       * @param  : node* - node to move from
+       *         : size_type - first index to move
+       *         : size_type - index after the last to move
+       *         : node* - node to append to
+       * @return : none
+       */
+      void
+      move_elements (node *src, size_type first, size_type last, node *dst)
+      {
+        for (size_type j = first; j < last; j++)
+        {
+          ::new (dst->at (dst->count++)) T (std::move (*src->at (j)));
+        }
+        for (size_type j = last; j < src->count; j++)
+        {
+          *src->at (j - last + first) = std::move (*src->at (j));
+        }
+        size_type new_count = src->count - (last - first);
+        for (size_type j = new_count; j < src->count; j++)
+        {
+          src->at (j)->~T ();
+        }
+        src->count = new_count;
+      }
+
+      /**
+       * destroy every element, the nodes stay in the pool
+       * which the caller releases or hands over afterwards
+       *
+       * @param  : none
+       * @return : none
+       */
+      void
+      destroy_elements () noexcept
+      {
+        if (!std::is_trivially_destructible<T>::value)
+        {
+          for (node *n = m_head; n != nullptr; n = n->next)
+          {
+            for (size_type j = 0; j < n->count; j++)
+            {
+              n->at (j)->~T ();
+            }
+          }
+        }
+        m_head = m_tail = nullptr;
+        m_size = m_nodes = 0;
+      }
+
+      node *m_head, *m_tail;
+      size_type m_size;
+      size_type m_nodes;
+      node_pool<node> m_pool;
+    };
+
+}
+
+#endif /* _UNROLLED_LIST_HPP_*/
@@ -35,7 +35,14 @@ using namespace std;
 using namespace miniSTL;
 #endif
 
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <random>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 
 /**
@@ -64,9 +71,9 @@ template<typename T>
  * @param  : none
  * @return : none
  */
-template<typename T>
+template<typename L, typename T>
   void
-  compare_list (list<T> &_l, std::list<T> &_l_std)
+  compare_list (L &_l, std::list<T> &_l_std)
   {
     if (_l.begin () == _l.end ())
     {
@@ -413,6 +420,607 @@ TEST(list_test, insert)
   }
 }
 
+TEST(list_test, string_elements)
+{
+  /* non trivial elements are destroyed through the pool on
+   erase, pop and when the list goes away */
+  list<std::string> l1;
+  std::list<std::string> l1_std;
+  for (int i = 0; i < 100; i++)
+  {
+    l1.push_back (std::string (40, 'a' + i % 26));
+    l1_std.push_back (std::string (40, 'a' + i % 26));
+  }
+  auto iter = l1.begin ();
+  auto iter_std = l1_std.begin ();
+  for (int i = 0; i < 10; i++, iter++, iter_std++)
+    ;
+  iter = l1.erase (iter);
+  iter_std = l1_std.erase (iter_std);
+  l1.pop_front ();
+  l1_std.pop_front ();
+  l1.insert (iter, std::string (50, 'z'));
+  l1_std.insert (iter_std, std::string (50, 'z'));
+  compare_list (l1, l1_std);
+
+  list<std::string> l2 (std::move (l1));
+  l2.push_back ("moved");
+  l1_std.push_back ("moved");
+  compare_list (l2, l1_std);
+  ASSERT_EQ(1, l1.empty ());
+}
+
+#ifndef __STDLIB__
+TEST(list_test, node_pool)
+{
+  node_pool<long> pool;
+  std::vector<long*> slots;
+  for (int i = 0; i < 1000; i++)
+  {
+    slots.push_back (pool.allocate ());
+    *slots.back () = i;
+  }
+  /* slabs double in size, so 1000 slots need about
+   log2 (1000) of them */
+  ASSERT_EQ(1, pool.slab_count () <= 10);
+  for (int i = 0; i < 1000; i++)
+  {
+    ASSERT_EQ(i, *slots[i]);
+  }
+
+  /* freed slots are handed out again before the pool grows */
+  size_t slabs = pool.slab_count ();
+  for (int i = 0; i < 500; i++)
+  {
+    pool.deallocate (slots[i]);
+  }
+  for (int i = 499; i >= 0; i--)
+  {
+    ASSERT_EQ(1, pool.allocate () == slots[i]);
+  }
+  ASSERT_EQ(slabs, pool.slab_count ());
+
+  pool.release ();
+  ASSERT_EQ(0u, pool.slab_count ());
+}
+#endif
+
+#ifndef __STDLIB__
+/**
+ * allocator which keeps a count of the bytes it has
+ * handed out and not yet seen back
+ */
+template<typename T>
+  struct counting_allocator
+  {
+    typedef T value_type;
+
+    explicit
+    counting_allocator (long *live, long *limit = nullptr) :
+        live (live), limit (limit)
+    {
+    }
+
+    template<typename U>
+      counting_allocator (const counting_allocator<U> &other) :
+          live (other.live), limit (other.limit)
+      {
+      }
+
+    T*
+    allocate (size_t n)
+    {
+      if (limit != nullptr && *live + (long) (n * sizeof(T)) > *limit)
+      {
+        throw std::bad_alloc ();
+      }
+      *live += n * sizeof(T);
+      return static_cast<T*> (::operator new (n * sizeof(T)));
+    }
+
+    void
+    deallocate (T *p, size_t n)
+    {
+      *live -= n * sizeof(T);
+      ::operator delete (p);
+    }
+
+    long *live;
+    long *limit;
+  };
+
+template<typename T, typename U>
+  bool
+  operator== (const counting_allocator<T> &a, const counting_allocator<U> &b)
+  {
+    return a.live == b.live;
+  }
+
+template<typename T, typename U>
+  bool
+  operator!= (const counting_allocator<T> &a, const counting_allocator<U> &b)
+  {
+    return a.live != b.live;
+  }
+
+TEST(list_test, allocator)
+{
+  typedef counting_allocator<int> alloc_t;
+  long live_a = 0, live_b = 0;
+  alloc_t alloc_a (&live_a), alloc_b (&live_b);
+  {
+    list<int, alloc_t> l1 (alloc_a);
+    std::list<int> l1_std;
+    /* a list of one takes little more than its node */
+    l1.push_back (0);
+    l1_std.push_back (0);
+    ASSERT_EQ(1, live_a > 0 && live_a <= 4 * 3 * (long) sizeof(void*));
+    for (int i = 1; i < 100; i++)
+    {
+      l1.push_back (i);
+      l1_std.push_back (i);
+    }
+    ASSERT_EQ(1, l1.get_allocator () == alloc_a);
+
+    /* move construction takes the slabs along */
+    list<int, alloc_t> l2 (std::move (l1));
+    ASSERT_EQ(1, l1.empty ());
+    compare_list (l2, l1_std);
+
+    /* a copy allocates from the allocator it is given */
+    list<int, alloc_t> l3 (l2, alloc_b);
+    ASSERT_EQ(1, live_b > 0);
+    compare_list (l3, l1_std);
+
+    /* unequal allocators which do not propagate on move
+     assignment make the elements move, not the nodes */
+    long before = live_a;
+    l3 = std::move (l2);
+    ASSERT_EQ(before, live_a);
+    ASSERT_EQ(1, l3.get_allocator () == alloc_b);
+    compare_list (l3, l1_std);
+
+    l3.clear ();
+    ASSERT_EQ(0, live_b);
+  }
+  ASSERT_EQ(0, live_a);
+  ASSERT_EQ(0, live_b);
+}
+#endif
+
+#ifdef _LIST_HAVE_PMR_
+TEST(list_test, pmr)
+{
+  char buffer[4096];
+  std::pmr::monotonic_buffer_resource arena (buffer, sizeof(buffer));
+  {
+    pmr::list<std::pmr::string> l1 (&arena);
+    l1.push_back ("a string long enough to need heap storage");
+    l1.push_back ("and another one to go with it");
+    ASSERT_EQ(1, l1.get_allocator ().resource () == &arena);
+    /* elements are constructed with the list's allocator */
+    ASSERT_EQ(1, l1.front ().get_allocator ().resource () == &arena);
+    ASSERT_EQ(2u, l1.size ());
+  }
+  arena.release ();
+}
+#endif
+
+TEST(list_test, sort)
+{
+  std::mt19937 gen (49);
+  for (int n : { 0, 1, 2, 3, 17, 1000, 4097 })
+  {
+    list<int> l1;
+    std::list<int> l1_std;
+    for (int i = 0; i < n; i++)
+    {
+      int val = gen () % 500;
+      l1.push_back (val);
+      l1_std.push_back (val);
+    }
+    l1.sort ();
+    l1_std.sort ();
+    compare_list (l1, l1_std);
+    if (n)
+    {
+      ASSERT_EQ(l1_std.back (), l1.back ());
+    }
+
+    l1.sort (std::greater<int> ());
+    l1_std.sort (std::greater<int> ());
+    compare_list (l1, l1_std);
+  }
+
+  /* equal keys keep their order: key in the thousands,
+   position below */
+  list<int> l2;
+  std::list<int> l2_std;
+  for (int i = 0; i < 999; i++)
+  {
+    int val = (gen () % 10) * 1000 + i;
+    l2.push_back (val);
+    l2_std.push_back (val);
+  }
+  auto by_key = [](int a, int b)
+    { return a / 1000 < b / 1000;};
+  l2.sort (by_key);
+  l2_std.sort (by_key);
+  compare_list (l2, l2_std);
+}
+
+TEST(list_test, sort_throwing_compare)
+{
+  /* every element is still in the list after a comparison
+   threw, wherever the sort was */
+  for (int throw_at = 1; throw_at < 26; throw_at += 2)
+  {
+    list<std::string> l1;
+    std::vector<std::string> res;
+    for (int i = 0; i < 13; i++)
+    {
+      res.push_back (std::string (20, 'a' + (i * 7) % 13));
+      l1.push_back (res.back ());
+    }
+    int calls = 0;
+    auto throwing = [&calls, throw_at](const std::string &a,
+        const std::string &b)
+      {
+        if (++calls == throw_at)
+        {
+          throw std::runtime_error ("compare");
+        }
+        return a < b;
+      };
+    ASSERT_THROW(l1.sort (throwing), std::runtime_error);
+    ASSERT_EQ(13u, l1.size ());
+    ASSERT_EQ(13, std::distance (l1.begin (), l1.end ()));
+    /* prev links and the tail are right again */
+    auto back = std::next (l1.begin (), 12);
+    ASSERT_EQ(1, &*back == &l1.back ());
+    for (int i = 0; i < 12; i++)
+    {
+      --back;
+    }
+    ASSERT_EQ(1, back == l1.begin ());
+    std::vector<std::string> all (l1.begin (), l1.end ());
+    std::sort (all.begin (), all.end ());
+    std::sort (res.begin (), res.end ());
+    ASSERT_EQ(1, all == res);
+    l1.sort ();
+    ASSERT_EQ(1, std::equal (res.begin (), res.end (), l1.begin ()));
+    ASSERT_EQ(res.back (), l1.back ());
+  }
+}
+
+TEST(list_test, splice)
+{
+  list<int> l1 = { 1, 2, 3, 4, 5 };
+  std::list<int> l1_std = { 1, 2, 3, 4, 5 };
+  auto iter = l1.begin ();
+  auto iter_std = l1_std.begin ();
+  iter++;
+  iter_std++;
+
+  {
+    /* whole list, the nodes outlive the list they came from */
+    list<int> l2 = { 10, 20, 30 };
+    std::list<int> l2_std = { 10, 20, 30 };
+    l1.splice (iter, l2);
+    l1_std.splice (iter_std, l2_std);
+    ASSERT_EQ(1, l2.empty ());
+    ASSERT_EQ(0u, l2.size ());
+    compare_list (l1, l1_std);
+  }
+  compare_list (l1, l1_std);
+
+  {
+    /* single elements and ranges from a list that goes away
+     while its other nodes stay with us */
+    list<int> l3 = { 100, 200, 300, 400, 500, 600 };
+    std::list<int> l3_std = { 100, 200, 300, 400, 500, 600 };
+    auto from = l3.begin ();
+    auto from_std = l3_std.begin ();
+    from++;
+    from_std++;
+    l1.splice (l1.end (), l3, from);
+    l1_std.splice (l1_std.end (), l3_std, from_std);
+    compare_list (l1, l1_std);
+    compare_list (l3, l3_std);
+
+    auto first = l3.begin ();
+    auto first_std = l3_std.begin ();
+    first++;
+    first_std++;
+    l1.splice (l1.begin (), l3, first, l3.end ());
+    l1_std.splice (l1_std.begin (), l3_std, first_std, l3_std.end ());
+    compare_list (l1, l1_std);
+    compare_list (l3, l3_std);
+    ASSERT_EQ(1, l3.size () == l3_std.size ());
+
+    /* and give some back so both hold nodes of the other */
+    l3.splice (l3.end (), l1, l1.begin ());
+    l3_std.splice (l3_std.end (), l1_std, l1_std.begin ());
+    compare_list (l3, l3_std);
+  }
+  compare_list (l1, l1_std);
+  l1.push_back (7);
+  l1_std.push_back (7);
+
+  /* within the same list */
+  auto first = l1.begin ();
+  auto first_std = l1_std.begin ();
+  auto last = first;
+  auto last_std = first_std;
+  last++;
+  last++;
+  last++;
+  last_std++;
+  last_std++;
+  last_std++;
+  l1.splice (l1.end (), l1, first, last);
+  l1_std.splice (l1_std.end (), l1_std, first_std, last_std);
+  compare_list (l1, l1_std);
+  /* end () can not be stepped back, walk to the last node */
+  l1.splice (l1.begin (), l1, std::next (l1.begin (), l1.size () - 1));
+  l1_std.splice (l1_std.begin (), l1_std, --l1_std.end ());
+  compare_list (l1, l1_std);
+
+  /* the last element of another list to the end */
+  list<int> l4 = { 1, 2 };
+  list<int> l5 = { 3, 4 };
+  std::list<int> l4_std = { 1, 2 };
+  std::list<int> l5_std = { 3, 4 };
+  l4.splice (l4.end (), l5, std::next (l5.begin ()));
+  l4_std.splice (l4_std.end (), l5_std, --l5_std.end ());
+  compare_list (l4, l4_std);
+  compare_list (l5, l5_std);
+
+  /* all of another list as a range, to the end */
+  l4.splice (l4.end (), l5, l5.begin (), l5.end ());
+  l4_std.splice (l4_std.end (), l5_std, l5_std.begin (), l5_std.end ());
+  compare_list (l4, l4_std);
+  compare_list (l5, l5_std);
+
+  /* lists emptied from either end take new elements */
+  list<int> l6 = { 8 };
+  list<int> l7 = { 9 };
+  std::list<int> l6_std = { 8 };
+  std::list<int> l7_std = { 9 };
+  l6.pop_front ();
+  l6_std.pop_front ();
+  l6.splice (l6.end (), l7);
+  l6_std.splice (l6_std.end (), l7_std);
+  compare_list (l6, l6_std);
+  l6.pop_back ();
+  l6_std.pop_back ();
+  l6.push_front (5);
+  l6_std.push_front (5);
+  compare_list (l6, l6_std);
+}
+
+#ifndef __STDLIB__
+TEST(list_test, splice_memory)
+{
+  /* a queue fed by splicing never holds more than a few
+   slabs, whatever came in and went out */
+  typedef counting_allocator<int> alloc_t;
+  long live = 0;
+  alloc_t alloc (&live);
+  list<int, alloc_t> queue (alloc);
+  long peak = 0;
+  for (int i = 0; i < 100000; i++)
+  {
+    list<int, alloc_t> one (alloc);
+    one.push_back (i);
+    queue.splice (queue.end (), one);
+    ASSERT_EQ(i, queue.front ());
+    queue.erase (queue.begin ());
+    peak = std::max (peak, live);
+  }
+  ASSERT_EQ(1, peak < 256 * 1024);
+
+  /* the same with single elements, so the pools are shared */
+  for (int i = 0; i < 100000; i++)
+  {
+    list<int, alloc_t> two (alloc);
+    two.push_back (i);
+    two.push_back (-i);
+    queue.splice (queue.end (), two, two.begin ());
+    ASSERT_EQ(1u, queue.size ());
+    queue.pop_front ();
+    peak = std::max (peak, live);
+  }
+  ASSERT_EQ(1, peak < 256 * 1024);
+  queue.clear ();
+  ASSERT_EQ(0, live);
+}
+
+TEST(list_test, splice_throwing_allocator)
+{
+  /* sharing the pools needs memory, when there is none
+   nothing is moved */
+  typedef counting_allocator<int> alloc_t;
+  long live = 0, limit = LONG_MAX;
+  alloc_t alloc (&live, &limit);
+  list<int, alloc_t> l1 (alloc), l2 (alloc);
+  std::list<int> l1_std, l2_std;
+  for (int i = 0; i < 5; i++)
+  {
+    l1.push_back (i);
+    l1_std.push_back (i);
+    l2.push_back (-i);
+    l2_std.push_back (-i);
+  }
+  limit = live;
+  ASSERT_THROW(
+      l1.splice (l1.end (), l2, std::next (l2.begin ()), l2.end ()),
+      std::bad_alloc);
+  ASSERT_THROW(l1.splice (l1.end (), l2, l2.begin ()), std::bad_alloc);
+  ASSERT_EQ(5u, l1.size ());
+  ASSERT_EQ(5u, l2.size ());
+  compare_list (l1, l1_std);
+  compare_list (l2, l2_std);
+
+  limit = LONG_MAX;
+  l1.splice (l1.end (), l2, std::next (l2.begin ()), l2.end ());
+  l1_std.splice (l1_std.end (), l2_std, std::next (l2_std.begin ()),
+                 l2_std.end ());
+  compare_list (l1, l1_std);
+  compare_list (l2, l2_std);
+}
+#endif
+
+TEST(list_test, splice_threads)
+{
+  /* lists that traded nodes may live on different threads,
+   also while their groups are merged */
+  for (int round = 0; round < 20; round++)
+  {
+    list<std::string> a1, a2, b1, b2;
+    for (int i = 0; i < 20; i++)
+    {
+      a1.push_back ("a1");
+      a2.push_back ("a2");
+      b1.push_back ("b1");
+      b2.push_back ("b2");
+    }
+    a1.splice (a1.end (), a2, a2.begin ());
+    b1.splice (b1.end (), b2, b2.begin ());
+    auto churn = [](list<std::string> *l)
+      {
+        for (int i = 0; i < 2000; i++)
+        {
+          l->push_back (std::string (24, 'a' + i % 26));
+          l->pop_front ();
+        }
+      };
+    std::thread t1 ([&]()
+      {
+        churn (&a1);
+        a1.splice (a1.end (), b1, b1.begin (), std::next (b1.begin (), 5));
+        churn (&a1);
+        b1.clear ();
+      });
+    std::thread t2 (churn, &a2);
+    std::thread t3 (churn, &b2);
+    t1.join ();
+    t2.join ();
+    t3.join ();
+    ASSERT_EQ(26u, a1.size ());
+    ASSERT_EQ(19u, a2.size ());
+    ASSERT_EQ(19u, b2.size ());
+    a1.clear ();
+    a2.clear ();
+    /* b2 is the last one left and reaches the group through
+     the one merged away */
+    churn (&b2);
+    ASSERT_EQ(std::string (24, 'a' + 1999 % 26), b2.back ());
+  }
+}
+
+TEST(list_test, merge)
+{
+  list<int> l1 = { 1, 3, 3, 8, 10 };
+  list<int> l2 = { 0, 3, 4, 11, 12 };
+  std::list<int> l1_std = { 1, 3, 3, 8, 10 };
+  std::list<int> l2_std = { 0, 3, 4, 11, 12 };
+  l1.merge (l2);
+  l1_std.merge (l2_std);
+  compare_list (l1, l1_std);
+  ASSERT_EQ(1, l2.empty ());
+
+  /* merging into an empty list, and with a comparison */
+  list<int> l3;
+  std::list<int> l3_std;
+  l1.reverse ();
+  l1_std.reverse ();
+  l3.merge (l1, std::greater<int> ());
+  l3_std.merge (l1_std, std::greater<int> ());
+  compare_list (l3, l3_std);
+
+  /* equal keys from this list come first */
+  list<int> l4 = { 1001, 2001, 3001 };
+  list<int> l5 = { 1002, 2002, 2003, 4002 };
+  std::list<int> l4_std = { 1001, 2001, 3001 };
+  std::list<int> l5_std = { 1002, 2002, 2003, 4002 };
+  auto by_key = [](int a, int b)
+    { return a / 1000 < b / 1000;};
+  l4.merge (l5, by_key);
+  l4_std.merge (l5_std, by_key);
+  compare_list (l4, l4_std);
+}
+
+TEST(list_test, merge_throwing_compare)
+{
+  /* a comparison that throws leaves both lists whole, and
+   together they still hold every element */
+  for (int throw_at = 1; throw_at <= 6; throw_at++)
+  {
+    list<std::string> l1 = { "b", "d", "f", "h" };
+    list<std::string> l2 = { "a", "c", "e", "g" };
+    int calls = 0;
+    auto throwing = [&calls, throw_at](const std::string &a,
+        const std::string &b)
+      {
+        if (++calls == throw_at)
+        {
+          throw std::runtime_error ("compare");
+        }
+        return a < b;
+      };
+    ASSERT_THROW(l1.merge (l2, throwing), std::runtime_error);
+    ASSERT_EQ(8u, l1.size () + l2.size ());
+    ASSERT_EQ(l1.size (), (size_t ) std::distance (l1.begin (), l1.end ()));
+    ASSERT_EQ(l2.size (), (size_t ) std::distance (l2.begin (), l2.end ()));
+    std::vector<std::string> all (l1.begin (), l1.end ());
+    all.insert (all.end (), l2.begin (), l2.end ());
+    std::sort (all.begin (), all.end ());
+    ASSERT_EQ(1, all == std::vector<std::string> (
+        { "a", "b", "c", "d", "e", "f", "g", "h" }));
+    /* both lists keep working */
+    l2.push_back ("z");
+    l1.push_front ("0");
+    ASSERT_EQ(1, std::is_sorted (l1.begin (), l1.end ()));
+    ASSERT_EQ(1, std::is_sorted (l2.begin (), l2.end ()));
+  }
+}
+
+TEST(list_test, reverse_unique_remove)
+{
+  list<int> l1 = { 1, 1, 2, 3, 3, 3, 4, 1, 1, 5 };
+  std::list<int> l1_std = { 1, 1, 2, 3, 3, 3, 4, 1, 1, 5 };
+  l1.reverse ();
+  l1_std.reverse ();
+  compare_list (l1, l1_std);
+
+  l1.unique ();
+  l1_std.unique ();
+  compare_list (l1, l1_std);
+
+  auto close = [](int a, int b)
+    { return b - a == 1 || a - b == 1;};
+  l1.unique (close);
+  l1_std.unique (close);
+  compare_list (l1, l1_std);
+
+  list<int> l2 = { 5, 1, 7, 1, 9, 2, 1 };
+  std::list<int> l2_std = { 5, 1, 7, 1, 9, 2, 1 };
+  /* the value removed lives in the list itself */
+  l2.remove (l2.back ());
+  l2_std.remove (l2_std.back ());
+  compare_list (l2, l2_std);
+
+  auto odd = [](int a)
+    { return a % 2 == 1;};
+  l2.remove_if (odd);
+  l2_std.remove_if (odd);
+  compare_list (l2, l2_std);
+  l2.remove_if (odd);
+  l2.remove (2);
+  ASSERT_EQ(1, l2.empty ());
+}
+
 /**
  * main function for test setup
  *
@@ -0,0 +1,280 @@
+/*
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Rohit Philip Mathew
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "common.hpp"
+#include "unrolled_list.hpp"
+#include <list>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace miniSTL;
+
+/**
+ * compares an unrolled list with a standard list, walking
+ * forward from begin and backward from end
+ *
+ * @param  : none
+ * @return : none
+ */
+template<typename T, size_t N>
+  void
+  compare_list (unrolled_list<T, N> &_l, std::list<T> &_l_std)
+  {
+    ASSERT_EQ(_l_std.size (), _l.size ());
+    auto _l_iter = _l.begin ();
+    for (auto &el : _l_std)
+    {
+      ASSERT_EQ(1, _l_iter != _l.end ());
+      ASSERT_EQ(el, *_l_iter++);
+    }
+    ASSERT_EQ(1, _l_iter == _l.end ());
+
+    for (auto _l_std_iter = _l_std.rbegin (); _l_std_iter != _l_std.rend ();
+        _l_std_iter++)
+    {
+      ASSERT_EQ(*_l_std_iter, *--_l_iter);
+    }
+    ASSERT_EQ(1, _l_iter == _l.begin ());
+
+    /* adjacent nodes always hold more than half a node */
+    ASSERT_EQ(1, _l.size () * 4 + 2 * N >= _l.node_count () * N);
+  }
+
+TEST(unrolled_list_test, constructors)
+{
+  unrolled_list<int, 4> l1;
+  std::list<int> l1_std;
+  compare_list (l1, l1_std);
+
+  unrolled_list<int, 4> l2 (10, 7);
+  std::list<int> l2_std (10, 7);
+  compare_list (l2, l2_std);
+  ASSERT_EQ(3u, l2.node_count ());
+
+  unrolled_list<int, 4> l3 = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  std::list<int> l3_std = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  compare_list (l3, l3_std);
+
+  unrolled_list<int, 4> l4 (l3);
+  compare_list (l4, l3_std);
+
+  unrolled_list<int, 4> l5 (std::move (l4));
+  compare_list (l5, l3_std);
+  ASSERT_EQ(1, l4.empty ());
+
+  l1 = l5;
+  compare_list (l1, l3_std);
+  l2 = std::move (l1);
+  compare_list (l2, l3_std);
+  l2.swap (l1);
+  compare_list (l1, l3_std);
+  ASSERT_EQ(1, l2.empty ());
+}
+
+TEST(unrolled_list_test, push_pop)
+{
+  unrolled_list<int, 4> l1;
+  std::list<int> l1_std;
+  for (int i = 0; i < 50; i++)
+  {
+    l1.push_back (i);
+    l1_std.push_back (i);
+    l1.push_front (-i);
+    l1_std.push_front (-i);
+  }
+  compare_list (l1, l1_std);
+  ASSERT_EQ(l1_std.front (), l1.front ());
+  ASSERT_EQ(l1_std.back (), l1.back ());
+
+  /* pushing an element of the list itself */
+  l1.push_front (l1.back ());
+  l1_std.push_front (l1_std.back ());
+  compare_list (l1, l1_std);
+
+  while (!l1_std.empty ())
+  {
+    l1.pop_back ();
+    l1_std.pop_back ();
+    if (!l1_std.empty ())
+    {
+      l1.pop_front ();
+      l1_std.pop_front ();
+    }
+    compare_list (l1, l1_std);
+  }
+  ASSERT_EQ(0u, l1.node_count ());
+}
+
+TEST(unrolled_list_test, random_insert_erase)
+{
+  std::mt19937 gen (48);
+  unrolled_list<long, 8> l1;
+  std::list<long> l1_std;
+  for (int round = 0; round < 4000; round++)
+  {
+    size_t pos = l1_std.empty () ? 0 : gen () % (l1_std.size () + 1);
+    auto iter = l1.begin ();
+    auto iter_std = l1_std.begin ();
+    for (size_t i = 0; i < pos; i++, ++iter, ++iter_std)
+      ;
+
+    /* grow for the first half, then shrink */
+    if ((round < 2000 ? gen () % 3 : gen () % 3 == 0) || l1_std.empty ())
+    {
+      long val = gen ();
+      iter = l1.insert (iter, val);
+      iter_std = l1_std.insert (iter_std, val);
+      ASSERT_EQ(*iter_std, *iter);
+    }
+    else if (iter_std != l1_std.end ())
+    {
+      iter = l1.erase (iter);
+      iter_std = l1_std.erase (iter_std);
+      ASSERT_EQ(1, (iter == l1.end ()) == (iter_std == l1_std.end ()));
+      if (iter_std != l1_std.end ())
+      {
+        ASSERT_EQ(*iter_std, *iter);
+      }
+    }
+    if (round % 100 == 0)
+    {
+      compare_list (l1, l1_std);
+    }
+  }
+  compare_list (l1, l1_std);
+
+  /* range insert and erase in the middle */
+  std::vector<long> more (37, 5);
+  auto iter = l1.begin ();
+  auto iter_std = l1_std.begin ();
+  for (size_t i = 0; i < l1_std.size () / 2; i++, ++iter, ++iter_std)
+    ;
+  iter = l1.insert (iter, more.begin (), more.end ());
+  iter_std = l1_std.insert (iter_std, more.begin (), more.end ());
+  ASSERT_EQ(1, std::distance (l1.begin (), iter)
+            == std::distance (l1_std.begin (), iter_std));
+  compare_list (l1, l1_std);
+  auto last = iter;
+  auto last_std = iter_std;
+  std::advance (last, 30);
+  std::advance (last_std, 30);
+  l1.erase (iter, last);
+  l1_std.erase (iter_std, last_std);
+  compare_list (l1, l1_std);
+}
+
+TEST(unrolled_list_test, stability)
+{
+  /* iterators into nodes that are not touched stay valid */
+  unrolled_list<std::string, 4> l1;
+  for (int i = 0; i < 40; i++)
+  {
+    l1.push_back (std::string (30, 'a' + i % 26));
+  }
+  auto first = l1.begin ();
+  std::string *first_addr = &*first;
+  for (int i = 0; i < 20; i++)
+  {
+    l1.insert (l1.end (), std::string (30, 'z'));
+    l1.pop_back ();
+    l1.erase (--l1.end ());
+  }
+  ASSERT_EQ(1, first_addr == &*l1.begin ());
+  ASSERT_EQ(std::string (30, 'a'), *first);
+  ASSERT_EQ(20u, l1.size ());
+}
+
+TEST(unrolled_list_test, density)
+{
+  /* ints pack into nodes of about two cache lines */
+  unrolled_list<int> l1;
+  for (int i = 0; i < 10000; i++)
+  {
+    l1.push_back (i);
+  }
+  size_t capacity = unrolled_capacity<int>::value;
+  ASSERT_EQ(1, capacity >= 8 && capacity <= 64);
+  ASSERT_EQ((10000 + capacity - 1) / capacity, l1.node_count ());
+  long sum = 0;
+  for (auto el : l1)
+  {
+    sum += el;
+  }
+  ASSERT_EQ(10000L * 9999 / 2, sum);
+}
+
+TEST(unrolled_list_test, const_iterators)
+{
+  typedef unrolled_list<int, 4> list_t;
+  static_assert (std::is_same<const int&,
+                 decltype(*std::declval<list_t::const_iterator> ())>::value,
+                 "const_iterator must not hand out mutable elements");
+  static_assert (std::is_same<const int*, list_t::const_pointer>::value,
+                 "const_pointer points to const");
+
+  list_t l1 = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  const list_t &cl1 = l1;
+  int expected = 1;
+  for (list_t::const_iterator iter = cl1.begin (); iter != cl1.end (); ++iter)
+  {
+    ASSERT_EQ(expected++, *iter);
+  }
+  list_t::const_iterator last = cl1.cend ();
+  --last;
+  ASSERT_EQ(9, *last);
+
+  /* iterators convert and compare with const_iterators */
+  list_t::iterator iter = l1.begin ();
+  list_t::const_iterator citer = iter;
+  ASSERT_EQ(1, citer == iter);
+  ASSERT_EQ(1, iter == citer);
+  ++citer;
+  ASSERT_EQ(1, iter != citer);
+  l1.erase (citer);
+  l1.insert (l1.cbegin (), 0);
+  ASSERT_EQ(0, l1.front ());
+  ASSERT_EQ(3, *std::next (l1.cbegin (), 2));
+}
+
+/**
+ * main function for test setup
+ *
+ * @param  : int - number of args
+ *         : char ** - list of args
+ * @return : int - status of main
+ */
+int
+main (int argc, char **argv)
+{
+
+  testing::InitGoogleTest (&argc, argv);
+  return RUN_ALL_TESTS ();
+}
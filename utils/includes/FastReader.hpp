@@ -0,0 +1,60 @@
+#ifndef FASTREADER_HPP
+#define FASTREADER_HPP
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+ * Read only memory map of a whole file, unmapped on destruction. Binary
+ * key files are used straight from the page cache through Keys(), with
+ * no copy at all. Errors are thrown as std::string.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string & path);
+    ~MappedFile();
+    const char * Data() const { return data; }
+    size_t Size() const { return size; }
+    // the file as raw 64 bit keys in host byte order, throws unless Size() is a multiple of 8
+    const uint64_t * Keys() const;
+    size_t KeyCount() const { return size / sizeof(uint64_t); }
+private:
+    MappedFile(const MappedFile &);
+    MappedFile & operator=(const MappedFile &);
+    char * data;
+    size_t size;
+};
+
+/*
+ * Appends the unsigned integers in [begin, end) to keys. Numbers are
+ * separated by any mix of spaces, tabs, newlines and commas, anything
+ * else is an error. Digits are converted 8 at a time with SWAR
+ * arithmetic on 64 bit words, so the parser never branches per digit.
+ * Throws std::string on bad characters and on values above 2^64 - 1.
+ * @return number of keys appended
+ */
+size_t ParseKeys(const char * begin, const char * end, std::vector<uint64_t> & keys);
+
+/*
+ * Loads a text file of integers into keys, which are replaced. Regular
+ * files are memory mapped and keys is reserved from a sample of the
+ * file, so it is filled without regrowing. "-" and pipes are read in
+ * large blocks.
+ */
+void ReadTextKeys(const std::string & path, std::vector<uint64_t> & keys);
+
+/*
+ * Loads a raw little endian file of 64 bit keys into keys, for "-" and
+ * pipes. Regular files are better mapped with MappedFile and read
+ * through Keys(), which copies nothing.
+ */
+void ReadBinaryKeys(const std::string & path, std::vector<uint64_t> & keys);
+
+/*
+ * True when path names a regular file, which MappedFile can map.
+ * "-" is stdin and never counts.
+ */
+bool IsRegularFile(const std::string & path);
+
+#endif /* FASTREADER_HPP */
@@ -0,0 +1,111 @@
+#ifndef FASTWRITER_HPP
+#define FASTWRITER_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Buffered output straight to a file descriptor. Integers are formatted
+ * two digits at a time from a lookup table into a large buffer, which is
+ * handed to write(2) whole, so dumping 10^8 keys is bound by the disk or
+ * pipe, not by formatting. Nothing goes through iostreams: flush
+ * std::cout first when mixing the two on stdout.
+ * Write errors are thrown as std::string.
+ */
+class FastWriter {
+public:
+    static const size_t DEFAULT_BUFFER = 1 << 20;
+
+    explicit FastWriter(int fd, size_t bufferSize = DEFAULT_BUFFER);
+    // flushes, errors are lost here, call Flush() to see them
+    ~FastWriter();
+
+    // any integer type in decimal, picked by signedness so int, unsigned,
+    // long and size_t all resolve on every ABI. char is written as is
+    template <typename Integer>
+    inline typename std::enable_if<std::is_integral<Integer>::value &&
+            !std::is_same<Integer, char>::value>::type Write(Integer value) {
+        WriteInteger(value, std::is_signed<Integer>());
+    }
+    inline void Write(char c) {
+        Reserve(1);
+        buffer[used++] = c;
+    }
+    void Write(const char * data, size_t length);
+    inline void Write(const std::string & text) {
+        Write(text.data(), text.size());
+    }
+    // raw bytes of the keys in host byte order (little endian on x86)
+    void WriteBinary(const uint64_t * keys, size_t count);
+    // every key followed by separator
+    void WriteText(const uint64_t * keys, size_t count, char separator);
+    void Flush();
+
+    /**
+     * Writes value in decimal, without a terminating zero
+     * @param out - room for 20 characters
+     * @param value
+     * @return characters written
+     */
+    static inline size_t Format(char * out, uint64_t value) {
+        size_t length = Digits(value);
+        char * p = out + length;
+        while (value >= 100) {
+            size_t pair = (value % 100) * 2;
+            value /= 100;
+            *--p = DIGIT_PAIRS[pair + 1];
+            *--p = DIGIT_PAIRS[pair];
+        }
+        if (value >= 10) {
+            *--p = DIGIT_PAIRS[value * 2 + 1];
+            *--p = DIGIT_PAIRS[value * 2];
+        } else {
+            *--p = (char) ('0' + value);
+        }
+        return length;
+    }
+
+    static inline size_t Digits(uint64_t value) {
+        size_t length = 1;
+        while (value >= 10000) {
+            value /= 10000;
+            length += 4;
+        }
+        return length + (value >= 10) + (value >= 100) + (value >= 1000);
+    }
+
+private:
+    FastWriter(const FastWriter &);
+    FastWriter & operator=(const FastWriter &);
+
+    inline void Reserve(size_t bytes) {
+        if (used + bytes > buffer.size()) Flush();
+    }
+    inline void WriteInteger(uint64_t value, std::false_type) {
+        Reserve(20);
+        used += Format(&buffer[used], value);
+    }
+    inline void WriteInteger(int64_t value, std::true_type) {
+        Reserve(21);
+        if (value < 0) {
+            buffer[used++] = '-';
+            // negate as unsigned, INT64_MIN has no positive counterpart
+            used += Format(&buffer[used], 0 - (uint64_t) value);
+        } else {
+            used += Format(&buffer[used], (uint64_t) value);
+        }
+    }
+    void WriteAll(const char * data, size_t length);
+
+    // "00" "01" ... "99"
+    static const char DIGIT_PAIRS[201];
+
+    int fd;
+    std::vector<char> buffer;
+    size_t used;
+};
+
+#endif /* FASTWRITER_HPP */
@@ -0,0 +1,156 @@
+#ifndef LATENCYHISTOGRAM_HPP
+#define LATENCYHISTOGRAM_HPP
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <vector>
+#include "CycleClock.hpp"
+
+/*
+ * HDR (high dynamic range) histogram of tick counts. Values below 128
+ * are counted exactly. Above that every power of two is split into 64
+ * buckets, so any value is known to within 1/64 (1.6%) from 0 up to
+ * 2^64. Recording is an index computation and an increment.
+ */
+class LatencyHistogram {
+public:
+    // 128 exact values, then 64 buckets for each of the shifts 1..57
+    static const size_t BUCKETS = 2 * 64 + 57 * 64;
+
+    LatencyHistogram();
+    inline void Record(uint64_t value) {
+        counts[Index(value)]++;
+        total++;
+        sum += value;
+        if (value < min) min = value;
+        if (value > max) max = value;
+    }
+    void Merge(const LatencyHistogram & other);
+    void Clear();
+
+    uint64_t Count() const { return total; }
+    uint64_t Min() const { return total ? min : 0; }
+    uint64_t Max() const { return max; }
+    double Mean() const { return total ? (double) sum / total : 0; }
+    // smallest recorded value v with at least q of all values <= v, q in [0, 1]
+    uint64_t Percentile(double q) const;
+    // count, mean and percentiles in ns
+    std::string Summary() const;
+
+    static inline size_t Index(uint64_t value) {
+        if (value < 128) return value;
+        int shift = HighestBit(value) - 6;
+        return shift * 64 + (value >> shift);
+    }
+    // largest value counted in bucket index
+    static uint64_t HighestValue(size_t index);
+
+private:
+    friend class LatencyRecorder;
+    static inline int HighestBit(uint64_t value) {
+#ifdef __GNUC__
+        return 63 - __builtin_clzll(value);
+#else
+        int bit = 0;
+        while (value >>= 1) bit++;
+        return bit;
+#endif
+    }
+
+    std::vector<uint64_t> counts;
+    uint64_t total;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+};
+
+/*
+ * Latency histogram any number of threads record into without locks or
+ * shared cache lines: each thread owns a histogram that only it writes,
+ * found through a thread local cache. The mutex is only taken the first
+ * time a thread records and by Merged(), which sums the per thread
+ * histograms while they keep recording.
+ */
+class LatencyRecorder {
+public:
+    LatencyRecorder();
+    ~LatencyRecorder();
+    inline void Record(uint64_t ticks) {
+        Local().Add(ticks);
+    }
+    LatencyHistogram Merged() const;
+
+private:
+    LatencyRecorder(const LatencyRecorder &);
+    LatencyRecorder & operator=(const LatencyRecorder &);
+
+    /*
+     * Written by its thread only, so a relaxed load and store replace a
+     * locked read-modify-write. Atomics keep concurrent merges defined.
+     */
+    struct ThreadHistogram {
+        std::atomic<uint64_t> counts[LatencyHistogram::BUCKETS];
+        std::atomic<uint64_t> total;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> min;
+        std::atomic<uint64_t> max;
+
+        ThreadHistogram();
+        inline void Add(uint64_t value) {
+            std::atomic<uint64_t> & count = counts[LatencyHistogram::Index(value)];
+            count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            if (value < min.load(std::memory_order_relaxed)) min.store(value, std::memory_order_relaxed);
+            if (value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+        }
+    };
+
+    // recorders a thread used last, by id so a new recorder at a freed address never matches
+    struct CacheEntry {
+        uint64_t id;
+        ThreadHistogram * histogram;
+    };
+    static const size_t CACHE_SIZE = 4;
+
+    inline ThreadHistogram & Local() {
+        static thread_local CacheEntry cache[CACHE_SIZE];
+        CacheEntry & entry = cache[id % CACHE_SIZE];
+        if (entry.id != id) {
+            entry.histogram = Register();
+            entry.id = id;
+        }
+        return *entry.histogram;
+    }
+    ThreadHistogram * Register();
+
+    const uint64_t id;
+    mutable std::mutex lock;
+    std::vector<ThreadHistogram *> histograms;
+    // thread that writes each histogram, found again after a cache eviction
+    std::vector<std::thread::id> owners;
+};
+
+/*
+ * Records the ticks from construction to destruction, for instance of
+ * one loop iteration:
+ *     for (...) { ScopedTimer timer(recorder); work(); }
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(LatencyRecorder & recorder) : recorder(recorder), start(CycleClock::Now()) {
+    }
+    ~ScopedTimer() {
+        recorder.Record(CycleClock::Now() - start);
+    }
+private:
+    ScopedTimer(const ScopedTimer &);
+    ScopedTimer & operator=(const ScopedTimer &);
+    LatencyRecorder & recorder;
+    uint64_t start;
+};
+
+#endif /* LATENCYHISTOGRAM_HPP */
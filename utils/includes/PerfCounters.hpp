@@ -0,0 +1,50 @@
+#ifndef PERFCOUNTERS_HPP
+#define PERFCOUNTERS_HPP
+#include <cstdint>
+#include <string>
+
+// Hardware events PerfCounters can count
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_EVENT_COUNT
+};
+
+/*
+ * Counts of one measured region. Events the kernel or the CPU would not
+ * give us are marked invalid instead of reading as zero.
+ */
+struct PerfSample {
+    uint64_t value[PERF_EVENT_COUNT];
+    bool valid[PERF_EVENT_COUNT];
+};
+
+/*
+ * perf_event_open counters for the calling thread, user space only.
+ * Open once and wrap each region in Start() / Stop(). Counters that
+ * cannot be opened (not Linux, perf_event_paranoid too strict, no PMU in
+ * a VM) are skipped, so callers always get a sample and can print n/a.
+ * When the kernel multiplexes counters the values are scaled up by
+ * time enabled / time running.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    // true if at least one event could be opened
+    bool Available() const;
+    void Start();
+    PerfSample Stop();
+    static const char * Name(PerfEvent event);
+    static std::string Describe(const PerfSample & sample, double perKey);
+private:
+    PerfCounters(const PerfCounters &);
+    PerfCounters & operator=(const PerfCounters &);
+    int fds[PERF_EVENT_COUNT];
+};
+
+#endif /* PERFCOUNTERS_HPP */
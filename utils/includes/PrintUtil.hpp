@@ -6,6 +6,7 @@
 #include <string>
 
 void PrintArray(const std::vector<uint64_t> & arr);
+void WriteArray(int fd, const std::vector<uint64_t> & arr, bool binary);
 const std::string PrintTime(std::chrono::high_resolution_clock::time_point & tStart,
         std::chrono::high_resolution_clock::time_point tStop);
 
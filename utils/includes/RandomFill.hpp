@@ -0,0 +1,159 @@
+#ifndef RANDOMFILL_HPP
+#define RANDOMFILL_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "Xoshiro.hpp"
+
+/*
+ * Parallel, reproducible generation of benchmark keys. The buffer is cut
+ * into chunks of RANDOM_CHUNK keys and chunk c is drawn from the seed's
+ * stream jumped c times, so every chunk has its own non overlapping
+ * stream and the result is the same whatever the number of threads.
+ *
+ * A distribution is any functor uint64_t (Xoshiro256 & gen, size_t i)
+ * returning key i; pattern distributions can ignore gen. Every chunk
+ * works on its own copy, so a distribution may keep state such as a
+ * spare normal deviate.
+ */
+static const size_t RANDOM_CHUNK = 1 << 16;
+
+// random 64 bit keys
+struct UniformKeys {
+    inline uint64_t operator()(Xoshiro256 & gen, size_t) const {
+        return gen();
+    }
+};
+
+// keys in [0, bound)
+struct BoundedKeys {
+    uint64_t bound;
+    explicit BoundedKeys(uint64_t bound) : bound(bound) {
+    }
+    inline uint64_t operator()(Xoshiro256 & gen, size_t) const {
+        return gen.Below(bound);
+    }
+};
+
+/*
+ * Normal keys rounded to integers, by Marsaglia's polar method: one log
+ * and one square root per two keys, the second one is kept for the next
+ * call. Values below 0 are clamped to 0.
+ */
+struct NormalKeys {
+    double mean;
+    double stddev;
+    double spare;
+    bool hasSpare;
+    NormalKeys(double mean, double stddev) : mean(mean), stddev(stddev), spare(0), hasSpare(false) {
+    }
+    inline uint64_t operator()(Xoshiro256 & gen, size_t) {
+        double z;
+        if (hasSpare) {
+            z = spare;
+            hasSpare = false;
+        } else {
+            double u, v, r;
+            do {
+                u = 2 * gen.Uniform() - 1;
+                v = 2 * gen.Uniform() - 1;
+                r = u * u + v * v;
+            } while (r >= 1 || r == 0);
+            double scale = std::sqrt(-2 * std::log(r) / r);
+            z = u * scale;
+            spare = v * scale;
+            hasSpare = true;
+        }
+        double value = mean + stddev * z;
+        return value <= 0 ? 0 : (uint64_t) (value + 0.5);
+    }
+};
+
+/*
+ * Zipf distributed ranks in [0, keys): rank k has probability
+ * proportional to 1 / (k + 1)^exponent. Uses Hormann and Derflinger's
+ * rejection-inversion, O(1) per key with no table however many keys.
+ */
+class ZipfKeys {
+public:
+    ZipfKeys(uint64_t keys, double exponent);
+    inline uint64_t operator()(Xoshiro256 & gen, size_t) const {
+        for (;;) {
+            double u = hIntegralKeys + gen.Uniform() * (hIntegralX1 - hIntegralKeys);
+            double x = HIntegralInverse(u);
+            double k = std::floor(x + 0.5);
+            if (k < 1) k = 1;
+            if (k > keys) k = keys;
+            if (k - x <= s || u >= HIntegral(k + 0.5) - H(k)) return (uint64_t) k - 1;
+        }
+    }
+
+private:
+    double H(double x) const;
+    double HIntegral(double x) const;
+    double HIntegralInverse(double x) const;
+
+    double keys;
+    double exponent;
+    double hIntegralX1;
+    double hIntegralKeys;
+    double s;
+};
+
+/**
+ * Fills out[0, N) with keys from distribution, reproducibly for seed
+ * @param out
+ * @param N
+ * @param seed
+ * @param distribution
+ * @param threads - 0 for one per hardware thread
+ */
+template <typename T, typename Distribution>
+void ParallelFill(T * out, size_t N, uint64_t seed, const Distribution & distribution, unsigned threads = 0) {
+    size_t chunks = (N + RANDOM_CHUNK - 1) / RANDOM_CHUNK;
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    if (threads > chunks) threads = chunks ? chunks : 1;
+
+    auto fillChunks = [&](size_t firstChunk, size_t lastChunk) {
+        Xoshiro256 stream(seed);
+        for (size_t c = 0; c < firstChunk; c++) {
+            stream.Jump();
+        }
+        for (size_t c = firstChunk; c < lastChunk; c++) {
+            Xoshiro256 gen(stream);
+            Distribution local(distribution);
+            size_t end = std::min(N, (c + 1) * RANDOM_CHUNK);
+            for (size_t i = c * RANDOM_CHUNK; i < end; i++) {
+                out[i] = (T) local(gen, i);
+            }
+            stream.Jump();
+        }
+    };
+    if (threads == 1) {
+        fillChunks(0, chunks);
+        return;
+    }
+    // reserved up front so only the thread constructor can throw
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    try {
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back(fillChunks, chunks * t / threads, chunks * (t + 1) / threads);
+        }
+    } catch (...) {
+        // a joinable thread must not be destroyed, wait for the ones started
+        for (auto & worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+    for (auto & worker : workers) {
+        worker.join();
+    }
+}
+
+#endif /* RANDOMFILL_HPP */
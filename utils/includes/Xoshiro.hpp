@@ -0,0 +1,100 @@
+#ifndef XOSHIRO_HPP
+#define XOSHIRO_HPP
+#include <cstdint>
+
+/*
+ * xoshiro256++ by Blackman and Vigna: 256 bits of state, period
+ * 2^256 - 1, a handful of shifts and adds per 64 bit output and it
+ * passes BigCrush. Jump() advances the state by 2^128 outputs, so
+ * streams started one jump apart never overlap, which is what lets
+ * threads fill disjoint parts of a buffer reproducibly. Meets the
+ * UniformRandomBitGenerator requirements, so it works with <random>.
+ */
+class Xoshiro256 {
+public:
+    typedef uint64_t result_type;
+
+    /**
+     * Spreads seed over the state with splitmix64, as the authors advise,
+     * so nearby seeds give unrelated streams
+     * @param seed
+     */
+    explicit Xoshiro256(uint64_t seed = 1) {
+        for (int i = 0; i < 4; i++) {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            s[i] = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    inline uint64_t operator()() {
+        uint64_t result = Rotate(s[0] + s[3], 23) + s[0];
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = Rotate(s[3], 45);
+        return result;
+    }
+
+    /**
+     * Lemire's multiply-shift: the high half of a 64x64 bit product.
+     * Biased by at most bound / 2^64, far below anything a benchmark sees.
+     * @param bound
+     * @return value in [0, bound)
+     */
+    inline uint64_t Below(uint64_t bound) {
+        return (uint64_t) (((unsigned __int128) (*this)() * bound) >> 64);
+    }
+
+    // uniform in [0, 1) with 53 random bits
+    inline double Uniform() {
+        return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // advances by 2^128 outputs
+    void Jump() {
+        static const uint64_t JUMP[4] = {
+            0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+        };
+        Advance(JUMP);
+    }
+
+    // advances by 2^192 outputs, for one stream of jumps per machine or process
+    void LongJump() {
+        static const uint64_t LONG_JUMP[4] = {
+            0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull
+        };
+        Advance(LONG_JUMP);
+    }
+
+private:
+    static inline uint64_t Rotate(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    // multiplies the state by the jump polynomial
+    void Advance(const uint64_t (&polynomial)[4]) {
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 4; i++) {
+            for (int b = 0; b < 64; b++) {
+                if (polynomial[i] & ((uint64_t) 1 << b)) {
+                    for (int j = 0; j < 4; j++) t[j] ^= s[j];
+                }
+                (*this)();
+            }
+        }
+        for (int j = 0; j < 4; j++) s[j] = t[j];
+    }
+
+    uint64_t s[4];
+};
+
+#endif /* XOSHIRO_HPP */
@@ -0,0 +1,30 @@
+#include "CycleClock.hpp"
+
+// Long enough that steady_clock's own cost and granularity are noise
+static const std::chrono::milliseconds CALIBRATION_TIME(20);
+
+/**
+ * Spins for CALIBRATION_TIME and compares ticks against steady_clock
+ * @return ns per tick
+ */
+static double Calibrate() {
+#ifdef CYCLECLOCK_HAVE_TSC
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t startTicks = CycleClock::NowOrdered();
+    std::chrono::steady_clock::time_point stop;
+    do {
+        stop = std::chrono::steady_clock::now();
+    } while (stop - start < CALIBRATION_TIME);
+    uint64_t stopTicks = CycleClock::NowOrdered();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    return stopTicks > startTicks ? ns / (stopTicks - startTicks) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+double CycleClock::NsPerTick() {
+    // thread safe one time initialisation
+    static const double nsPerTick = Calibrate();
+    return nsPerTick;
+}
@@ -0,0 +1,258 @@
+#include "FastReader.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// stdin and pipes are read this much at a time
+static const size_t READ_BLOCK = 1 << 20;
+// bytes looked at to guess how many keys a text file holds
+static const size_t SAMPLE_BYTES = 1 << 16;
+
+static const uint64_t ONES = 0x0101010101010101ull;
+
+static inline bool IsSeparator(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',';
+}
+
+static std::string Describe(const std::string & path) {
+    return path + ": " + std::strerror(errno);
+}
+
+/**
+ * Opens path, "-" being stdin
+ * @param path
+ * @return file descriptor
+ */
+static int OpenInput(const std::string & path) {
+    if (path == "-") return 0;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw Describe(path);
+    return fd;
+}
+
+MappedFile::MappedFile(const std::string & path) : data(nullptr), size(0) {
+    int fd = OpenInput(path);
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        std::string error = path + ": not a regular file";
+        if (fd != 0) close(fd);
+        throw error;
+    }
+    size = info.st_size;
+    if (size > 0) {
+        void * mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            std::string error = Describe(path);
+            if (fd != 0) close(fd);
+            throw error;
+        }
+        data = static_cast<char *>(mapped);
+        // read ahead aggressively, the file is walked front to back
+        madvise(data, size, MADV_SEQUENTIAL);
+        madvise(data, size, MADV_WILLNEED);
+    }
+    // the mapping outlives the descriptor
+    if (fd != 0) close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data) munmap(data, size);
+}
+
+const uint64_t * MappedFile::Keys() const {
+    if (size % sizeof(uint64_t) != 0) {
+        throw std::string("MappedFile: size is not a multiple of 8 bytes");
+    }
+    // mmap returns page aligned memory
+    return reinterpret_cast<const uint64_t *>(data);
+}
+
+/**
+ * Mask with 0x80 in each byte of word that is not an ASCII digit
+ * @param word
+ * @return mask
+ */
+static inline uint64_t NonDigits(uint64_t word) {
+    // high nibble must be 3 and low nibble at most 9, no carries cross bytes
+    uint64_t high = (word & (0xF0 * ONES)) ^ (0x30 * ONES);
+    uint64_t low = ((word & (0x0F * ONES)) + 0x06 * ONES) & (0xF0 * ONES);
+    uint64_t bad = high | low;
+    return (bad | ((bad & (0x7F * ONES)) + 0x7F * ONES)) & (0x80 * ONES);
+}
+
+/**
+ * Value of the 8 digit characters in word, first character in the
+ * lowest byte, by pairing up digits, then pairs, then quads
+ * @param word
+ * @return value
+ */
+static inline uint64_t EightDigits(uint64_t word) {
+    word = ((word & (0x0F * ONES)) * 2561) >> 8;
+    word = ((word & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+    return ((word & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+}
+
+/**
+ * Parses the number starting at p one digit at a time, checking for
+ * overflow. Used close to end, where 8 bytes cannot be loaded.
+ * @param p - first digit, advanced past the number
+ * @param end
+ * @return value
+ */
+static uint64_t ParseSlow(const char * & p, const char * end) {
+    uint64_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        uint64_t digit = *p - '0';
+        if (value > (UINT64_MAX - digit) / 10) {
+            throw std::string("ParseKeys: value does not fit in 64 bits");
+        }
+        value = value * 10 + digit;
+        p++;
+    }
+    return value;
+}
+
+static const uint64_t POWERS_OF_TEN[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+size_t ParseKeys(const char * begin, const char * end, std::vector<uint64_t> & keys) {
+    size_t before = keys.size();
+    const char * p = begin;
+    while (p < end) {
+        if (IsSeparator(*p)) {
+            p++;
+            continue;
+        }
+        if (*p < '0' || *p > '9') {
+            throw std::string("ParseKeys: unexpected character '") + *p + "'";
+        }
+        const char * start = p;
+        uint64_t value = 0;
+        size_t digits = 0;
+        while (end - p >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            uint64_t mask = NonDigits(word);
+            if (mask == 0) {
+                value = value * 100000000 + EightDigits(word);
+                digits += 8;
+                p += 8;
+                continue;
+            }
+            size_t length = __builtin_ctzll(mask) / 8;
+            if (length > 0) {
+                // leading zero bytes stand in for the missing digits
+                value = value * POWERS_OF_TEN[length] + EightDigits(word << (8 * (8 - length)));
+                digits += length;
+                p += length;
+            }
+            break;
+        }
+        if (end - p < 8 || digits > 19) {
+            // the tail of the input, or too long for the fast path to be exact
+            p = start;
+            value = ParseSlow(p, end);
+        }
+        if (p < end && !IsSeparator(*p)) {
+            throw std::string("ParseKeys: unexpected character '") + *p + "'";
+        }
+        keys.push_back(value);
+    }
+    return keys.size() - before;
+}
+
+/**
+ * Guesses the key count of a text buffer from its start
+ * @param data
+ * @param size
+ * @return keys to reserve
+ */
+static size_t EstimateKeys(const char * data, size_t size) {
+    size_t sample = size < SAMPLE_BYTES ? size : SAMPLE_BYTES;
+    size_t separators = 1;
+    for (size_t i = 0; i < sample; i++) {
+        separators += data[i] == ' ' || data[i] == '\n' || data[i] == ',';
+    }
+    // 1/8 extra for files whose numbers get longer further on
+    return (size_t) ((double) separators * size / (sample ? sample : 1) * 1.125) + 16;
+}
+
+bool IsRegularFile(const std::string & path) {
+    struct stat info;
+    return path != "-" && stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+}
+
+void ReadTextKeys(const std::string & path, std::vector<uint64_t> & keys) {
+    keys.clear();
+    if (IsRegularFile(path)) {
+        MappedFile file(path);
+        keys.reserve(EstimateKeys(file.Data(), file.Size()));
+        ParseKeys(file.Data(), file.Data() + file.Size(), keys);
+        return;
+    }
+
+    int fd = OpenInput(path);
+    std::vector<char> buffer(READ_BLOCK * 2);
+    // bytes of a number cut off at the end of the previous block
+    size_t carried = 0;
+    for (;;) {
+        if (buffer.size() - carried < READ_BLOCK) buffer.resize(carried + READ_BLOCK);
+        ssize_t got = read(fd, &buffer[carried], READ_BLOCK);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            std::string error = Describe(path);
+            if (fd != 0) close(fd);
+            throw error;
+        }
+        size_t filled = carried + got;
+        if (got == 0) {
+            ParseKeys(buffer.data(), buffer.data() + filled, keys);
+            break;
+        }
+        // parse up to the last separator, keep the rest for the next block
+        size_t cut = filled;
+        while (cut > 0 && !IsSeparator(buffer[cut - 1])) cut--;
+        ParseKeys(buffer.data(), buffer.data() + cut, keys);
+        carried = filled - cut;
+        std::memmove(buffer.data(), buffer.data() + cut, carried);
+    }
+    if (fd != 0) close(fd);
+}
+
+void ReadBinaryKeys(const std::string & path, std::vector<uint64_t> & keys) {
+    keys.clear();
+    if (IsRegularFile(path)) {
+        MappedFile file(path);
+        const uint64_t * mapped = file.Keys();
+        keys.assign(mapped, mapped + file.KeyCount());
+        return;
+    }
+
+    // read straight into the keys, no staging buffer
+    int fd = OpenInput(path);
+    size_t bytes = 0;
+    for (;;) {
+        if (keys.size() * sizeof(uint64_t) - bytes < READ_BLOCK) {
+            keys.resize((bytes + READ_BLOCK * 2) / sizeof(uint64_t));
+        }
+        char * out = reinterpret_cast<char *>(keys.data()) + bytes;
+        ssize_t got = read(fd, out, keys.size() * sizeof(uint64_t) - bytes);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            std::string error = Describe(path);
+            if (fd != 0) close(fd);
+            throw error;
+        }
+        if (got == 0) break;
+        bytes += got;
+    }
+    if (fd != 0) close(fd);
+    if (bytes % sizeof(uint64_t) != 0) {
+        throw path + ": size is not a multiple of 8 bytes";
+    }
+    keys.resize(bytes / sizeof(uint64_t));
+}
@@ -0,0 +1,84 @@
+#include "FastWriter.hpp"
+#include <cerrno>
+#include <unistd.h>
+
+const size_t FastWriter::DEFAULT_BUFFER;
+
+const char FastWriter::DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * @param fd - open for writing, not closed by the writer
+ * @param bufferSize - at least 64 bytes
+ */
+FastWriter::FastWriter(int fd, size_t bufferSize) : fd(fd), buffer(bufferSize < 64 ? 64 : bufferSize),
+        used(0) {
+}
+
+FastWriter::~FastWriter() {
+    try {
+        Flush();
+    } catch (std::string) {
+    }
+}
+
+/**
+ * write(2) until everything is out, retrying short writes and signals
+ * @param data
+ * @param length
+ */
+void FastWriter::WriteAll(const char * data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::string("FastWriter: write failed: ") + std::strerror(errno);
+        }
+        data += written;
+        length -= written;
+    }
+}
+
+void FastWriter::Flush() {
+    size_t length = used;
+    // the buffer starts over even if WriteAll throws
+    used = 0;
+    WriteAll(buffer.data(), length);
+}
+
+/**
+ * Copies data into the buffer, large blocks skip it
+ * @param data
+ * @param length
+ */
+void FastWriter::Write(const char * data, size_t length) {
+    if (length >= buffer.size() / 2) {
+        Flush();
+        WriteAll(data, length);
+        return;
+    }
+    Reserve(length);
+    std::memcpy(&buffer[used], data, length);
+    used += length;
+}
+
+void FastWriter::WriteBinary(const uint64_t * keys, size_t count) {
+    Write(reinterpret_cast<const char *>(keys), count * sizeof(uint64_t));
+}
+
+void FastWriter::WriteText(const uint64_t * keys, size_t count, char separator) {
+    for (size_t i = 0; i < count; i++) {
+        Reserve(21);
+        used += Format(&buffer[used], keys[i]);
+        buffer[used++] = separator;
+    }
+}
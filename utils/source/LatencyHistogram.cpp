@@ -0,0 +1,140 @@
+#include "LatencyHistogram.hpp"
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+// ids are never reused, see LatencyRecorder::CacheEntry
+static std::atomic<uint64_t> nextRecorderId(1);
+
+const size_t LatencyHistogram::BUCKETS;
+
+LatencyHistogram::LatencyHistogram() : counts(BUCKETS, 0) {
+    Clear();
+}
+
+void LatencyHistogram::Clear() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    sum = 0;
+    min = std::numeric_limits<uint64_t>::max();
+    max = 0;
+}
+
+/**
+ * Adds every value of other
+ * @param other
+ */
+void LatencyHistogram::Merge(const LatencyHistogram & other) {
+    for (size_t i = 0; i < BUCKETS; i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    if (other.min < min) min = other.min;
+    if (other.max > max) max = other.max;
+}
+
+/**
+ * @param index
+ * @return largest value Index() maps to index
+ */
+uint64_t LatencyHistogram::HighestValue(size_t index) {
+    if (index < 128) return index;
+    int shift = index / 64 - 1;
+    uint64_t lowest = (uint64_t) (index - shift * 64) << shift;
+    return lowest + ((uint64_t) 1 << shift) - 1;
+}
+
+/**
+ * Walks the buckets up to the q-th value. Accurate to a bucket width,
+ * and never above the largest recorded value.
+ * @param q - 0.5 for the median, 0.99 for p99
+ * @return value in ticks, 0 if nothing was recorded
+ */
+uint64_t LatencyHistogram::Percentile(double q) const {
+    if (total == 0) return 0;
+    if (q <= 0) return Min();
+    uint64_t rank = (uint64_t) std::ceil(q * total);
+    if (rank > total) rank = total;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t value = HighestValue(i);
+            return value < max ? value : max;
+        }
+    }
+    return max;
+}
+
+/**
+ * @return e.g. "n 1000000 mean 31.2 ns min 25.1 p50 30.4 p90 33.0 p99 41.8 p99.9 120.3 max 5123.0"
+ */
+std::string LatencyHistogram::Summary() const {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "n " << total << " mean " << Mean() * CycleClock::NsPerTick() << " ns"
+       << " min " << CycleClock::ToNs(Min())
+       << " p50 " << CycleClock::ToNs(Percentile(0.5))
+       << " p90 " << CycleClock::ToNs(Percentile(0.9))
+       << " p99 " << CycleClock::ToNs(Percentile(0.99))
+       << " p99.9 " << CycleClock::ToNs(Percentile(0.999))
+       << " max " << CycleClock::ToNs(Max());
+    return ss.str();
+}
+
+LatencyRecorder::ThreadHistogram::ThreadHistogram() : total(0), sum(0),
+        min(std::numeric_limits<uint64_t>::max()), max(0) {
+    for (size_t i = 0; i < LatencyHistogram::BUCKETS; i++) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencyRecorder::LatencyRecorder() : id(nextRecorderId++) {
+}
+
+LatencyRecorder::~LatencyRecorder() {
+    for (size_t i = 0; i < histograms.size(); i++) {
+        delete histograms[i];
+    }
+}
+
+/**
+ * Slow path of Record(): finds or creates the calling thread's histogram
+ * @return histogram only the calling thread writes
+ */
+LatencyRecorder::ThreadHistogram * LatencyRecorder::Register() {
+    std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> guard(lock);
+    for (size_t i = 0; i < owners.size(); i++) {
+        if (owners[i] == self) return histograms[i];
+    }
+    histograms.push_back(new ThreadHistogram());
+    owners.push_back(self);
+    return histograms.back();
+}
+
+/**
+ * Sums every thread's histogram. Threads may keep recording meanwhile,
+ * their latest few values may or may not be included.
+ * @return merged histogram
+ */
+LatencyHistogram LatencyRecorder::Merged() const {
+    LatencyHistogram merged;
+    std::lock_guard<std::mutex> guard(lock);
+    for (size_t h = 0; h < histograms.size(); h++) {
+        const ThreadHistogram & local = *histograms[h];
+        for (size_t i = 0; i < LatencyHistogram::BUCKETS; i++) {
+            merged.counts[i] += local.counts[i].load(std::memory_order_relaxed);
+        }
+        merged.total += local.total.load(std::memory_order_relaxed);
+        merged.sum += local.sum.load(std::memory_order_relaxed);
+        uint64_t min = local.min.load(std::memory_order_relaxed);
+        uint64_t max = local.max.load(std::memory_order_relaxed);
+        if (min < merged.min) merged.min = min;
+        if (max > merged.max) merged.max = max;
+    }
+    return merged;
+}
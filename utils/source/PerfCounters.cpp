@@ -0,0 +1,140 @@
+#include "PerfCounters.hpp"
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * Opens one disabled user space counter for the calling thread
+ * @param type
+ * @param config
+ * @return file descriptor, -1 if the event is not available
+ */
+static int OpenEvent(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/**
+ * Cache event config: which cache, which operation, miss or access
+ */
+static uint64_t CacheEvent(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+#endif
+
+PerfCounters::PerfCounters() {
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        fds[e] = -1;
+    }
+#ifdef __linux__
+    fds[PERF_CYCLES] = OpenEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds[PERF_INSTRUCTIONS] = OpenEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[PERF_BRANCH_MISSES] = OpenEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds[PERF_L1D_MISSES] = OpenEvent(PERF_TYPE_HW_CACHE, CacheEvent(PERF_COUNT_HW_CACHE_L1D,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    fds[PERF_LLC_MISSES] = OpenEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds[PERF_DTLB_MISSES] = OpenEvent(PERF_TYPE_HW_CACHE, CacheEvent(PERF_COUNT_HW_CACHE_DTLB,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        if (fds[e] >= 0) close(fds[e]);
+    }
+#endif
+}
+
+bool PerfCounters::Available() const {
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        if (fds[e] >= 0) return true;
+    }
+    return false;
+}
+
+/**
+ * Zeroes and enables every open counter
+ */
+void PerfCounters::Start() {
+#ifdef __linux__
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        if (fds[e] < 0) continue;
+        ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/**
+ * Disables the counters and reads them
+ * @return counts since Start()
+ */
+PerfSample PerfCounters::Stop() {
+    PerfSample sample;
+    std::memset(&sample, 0, sizeof(sample));
+#ifdef __linux__
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        if (fds[e] >= 0) ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        // value, time enabled, time running
+        uint64_t data[3];
+        if (fds[e] < 0 || read(fds[e], data, sizeof(data)) != sizeof(data)) continue;
+        if (data[2] == 0) continue;
+        sample.value[e] = data[2] < data[1] ? (uint64_t) ((double) data[0] * data[1] / data[2]) : data[0];
+        sample.valid[e] = true;
+    }
+#endif
+    return sample;
+}
+
+/**
+ * @param event
+ * @return short name for reports
+ */
+const char * PerfCounters::Name(PerfEvent event) {
+    static const char * const names[PERF_EVENT_COUNT] = {
+        "cycles", "instructions", "branch-misses", "l1d-misses", "llc-misses", "dtlb-misses"
+    };
+    return event < PERF_EVENT_COUNT ? names[event] : "unknown";
+}
+
+/**
+ * One line summary: IPC and every event scaled by perKey
+ * @param sample
+ * @param perKey - 1.0 / number of keys, or 1 for raw counts
+ * @return e.g. "ipc 1.92 cycles 210.4 ... dtlb-misses n/a"
+ */
+std::string PerfCounters::Describe(const PerfSample & sample, double perKey) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2) << "ipc ";
+    if (sample.valid[PERF_CYCLES] && sample.valid[PERF_INSTRUCTIONS] && sample.value[PERF_CYCLES]) {
+        ss << (double) sample.value[PERF_INSTRUCTIONS] / sample.value[PERF_CYCLES];
+    } else {
+        ss << "n/a";
+    }
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        ss << " " << Name((PerfEvent) e) << " ";
+        if (sample.valid[e]) {
+            ss << sample.value[e] * perKey;
+        } else {
+            ss << "n/a";
+        }
+    }
+    return ss.str();
+}
@@ -1,14 +1,31 @@
 #include "PrintUtil.hpp"
+#include "FastWriter.hpp"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 void PrintArray(const std::vector<uint64_t> & arr) {
-#if 1    
-    for (std::vector<uint64_t> :: const_iterator c_it = arr.begin(); c_it != arr.end(); c_it++) {
-        std::cout << *c_it << " " ;
+    // anything already in cout's buffer goes first
+    std::cout.flush();
+    WriteArray(1, arr, false);
+}
+
+/**
+ * Writes arr space separated with a trailing newline, or as raw keys
+ * @param fd
+ * @param arr
+ * @param binary - 8 bytes per key in host byte order, nothing else
+ */
+void WriteArray(int fd, const std::vector<uint64_t> & arr, bool binary) {
+    // small arrays do not need a megabyte of buffer
+    FastWriter out(fd, std::min(FastWriter::DEFAULT_BUFFER, arr.size() * 21 + 1));
+    if (binary) {
+        out.WriteBinary(arr.data(), arr.size());
+    } else {
+        out.WriteText(arr.data(), arr.size(), ' ');
+        out.Write('\n');
     }
-    std::cout << std::endl;
-#endif    
+    out.Flush();
 }
 
 const std::string PrintTime(std::chrono::high_resolution_clock::time_point & tStart,
@@ -0,0 +1,42 @@
+#include "RandomFill.hpp"
+
+/**
+ * log1p(x) / x, accurate near 0
+ */
+static double Helper1(double x) {
+    return std::fabs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+/**
+ * expm1(x) / x, accurate near 0
+ */
+static double Helper2(double x) {
+    return std::fabs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+}
+
+/**
+ * @param keys - number of distinct ranks, at least 1
+ * @param exponent - greater than 0, 1 for classic Zipf
+ */
+ZipfKeys::ZipfKeys(uint64_t keys, double exponent) : keys(keys ? keys : 1), exponent(exponent) {
+    hIntegralX1 = HIntegral(1.5) - 1;
+    hIntegralKeys = HIntegral(this->keys + 0.5);
+    s = 2 - HIntegralInverse(HIntegral(2.5) - H(2));
+}
+
+// the unnormalised density x^-exponent
+double ZipfKeys::H(double x) const {
+    return std::exp(-exponent * std::log(x));
+}
+
+// integral of H, continuous in exponent through 1
+double ZipfKeys::HIntegral(double x) const {
+    double logX = std::log(x);
+    return Helper2((1 - exponent) * logX) * logX;
+}
+
+double ZipfKeys::HIntegralInverse(double x) const {
+    double t = x * (1 - exponent);
+    if (t < -1) t = -1;
+    return std::exp(Helper1(t) * x);
+}